@@ -56,6 +56,7 @@ from m5.util.fdthelper import *
 addToPath('../')
 
 from ruby import Ruby
+from network import Network
 
 from common.FSConfig import *
 from common.SysPaths import *
@@ -361,6 +362,9 @@ else:
     print("Error I don't know how to create more than 2 systems.")
     sys.exit(1)
 
+if options.ruby:
+    Network.init_network_threads(options, root)
+
 if options.timesync:
     root.time_sync_enable = True
 
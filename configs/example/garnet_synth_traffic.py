@@ -39,6 +39,7 @@ addToPath('../')
 
 from common import Options
 from ruby import Ruby
+from network import Network
 
 # Get paths we might need.  It's expected this file is in m5/configs/example.
 config_path = os.path.dirname(os.path.abspath(__file__))
@@ -146,6 +147,7 @@ root.system.mem_mode = 'timing'
 
 # Not much point in this being higher than the L1 latency
 m5.ticks.setGlobalFrequency('1ns')
+Network.init_network_threads(options, root)
 
 # instantiate configuration
 m5.instantiate()
@@ -0,0 +1,123 @@
+# Copyright (c) 2026 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from __future__ import print_function
+from __future__ import absolute_import
+
+import m5
+from m5.objects import *
+from m5.defines import buildEnv
+from m5.util import addToPath
+import os, optparse, sys
+
+addToPath('../')
+
+from common import Options
+from ruby import Ruby
+from network import Network
+
+parser = optparse.OptionParser()
+Options.addNoISAOptions(parser)
+
+parser.add_option("--trace", type="string", default="",
+                  help="Network trace to replay (recorded with\
+                        --network-trace). Assumes one L1 cache and one\
+                        directory per router.")
+
+parser.add_option("--dependency", action="store_true", default=False,
+                  help="Throttle injection on the packets received by\
+                        each node, instead of replaying the recorded\
+                        injection times open-loop.")
+
+#
+# Add the ruby specific and protocol specific options
+#
+Ruby.define_options(parser)
+
+(options, args) = parser.parse_args()
+
+if args:
+     print("Error: script doesn't take any positional arguments")
+     sys.exit(1)
+
+if not options.trace:
+     print("Error: --trace is required")
+     sys.exit(1)
+
+if options.network != "garnet2.0":
+     print("Error: network trace replay requires --network=garnet2.0")
+     sys.exit(1)
+
+
+cpus = [ GarnetTraceTraffic(
+                     trace_file=options.trace,
+                     dependency=options.dependency,
+                     num_dest=options.num_dirs) \
+         for i in range(options.num_cpus) ]
+
+# create the desired simulated system
+system = System(cpu = cpus, mem_ranges = [AddrRange(options.mem_size)])
+
+
+# Create a top-level voltage domain and clock domain
+system.voltage_domain = VoltageDomain(voltage = options.sys_voltage)
+
+system.clk_domain = SrcClockDomain(clock = options.sys_clock,
+                                   voltage_domain = system.voltage_domain)
+
+Ruby.create_system(options, False, system)
+
+# Create a seperate clock domain for Ruby
+system.ruby.clk_domain = SrcClockDomain(clock = options.ruby_clock,
+                                        voltage_domain = system.voltage_domain)
+
+i = 0
+for ruby_port in system.ruby._cpu_ports:
+     #
+     # Tie the cpu test ports to the ruby cpu port
+     #
+     cpus[i].test = ruby_port.slave
+     cpus[i].network = system.ruby.network
+     i += 1
+
+# -----------------------
+# run simulation
+# -----------------------
+
+root = Root(full_system = False, system = system)
+root.system.mem_mode = 'timing'
+
+# The trace keeps its own tick frequency: packet times are scaled to
+# the simulation's
+Network.init_network_threads(options, root)
+
+# instantiate configuration
+m5.instantiate()
+
+# simulate until the trace has been replayed
+exit_event = m5.simulate(options.abs_max_tick)
+
+print('Exiting @ tick', m5.curTick(), 'because', exit_event.getCause())
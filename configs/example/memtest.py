@@ -86,6 +86,9 @@ parser.add_option("-c", "--caches", type="string", default="2:2:1",
                   "[default: %default]")
 parser.add_option("--noncoherent-cache", action="store_true",
                   help="Adds a non-coherent, last-level cache")
+parser.add_option("--snoop-region", type="string", default=None,
+                  help="Size of the regions grouped together in the "
+                  "snoop filters of the crossbars")
 parser.add_option("-t", "--testers", type="string", default="1:1:0:2",
                   help="Colon-separated tester hierarchy specification, "
                   "see script comments for details "
@@ -231,6 +234,13 @@ system.voltage_domain = VoltageDomain(voltage = '1V')
 system.clk_domain = SrcClockDomain(clock =  options.sys_clock,
                         voltage_domain = system.voltage_domain)
 
+# Create a crossbar, with the requested snoop filter region size
+def make_xbar():
+     xbar = L2XBar()
+     if options.snoop_region:
+          xbar.snoop_filter.region_size = options.snoop_region
+     return xbar
+
 # For each level, track the next subsys index to use
 next_subsys_index = [0] * (len(cachespec) + 1)
 
@@ -265,7 +275,7 @@ def make_cache_level(ncaches, prototypes, level, next_cache):
      if level != 0:
           # Create a crossbar and add it to the subsystem, note that
           # we do this even with a single element on this level
-          xbar = L2XBar()
+          xbar = make_xbar()
           subsys.xbar = xbar
           if next_cache:
                xbar.master = next_cache.cpu_side
@@ -290,7 +300,7 @@ def make_cache_level(ncaches, prototypes, level, next_cache):
 
           if ntesters > 1:
                # Create a crossbar and add it to the subsystem
-               xbar = L2XBar()
+               xbar = make_xbar()
                subsys.xbar = xbar
                xbar.master = next_cache.cpu_side
                for tester in testers:
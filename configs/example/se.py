@@ -57,6 +57,7 @@ from m5.util import addToPath, fatal, warn
 addToPath('../')
 
 from ruby import Ruby
+from network import Network
 
 from common import Options
 from common import Simulation
@@ -279,4 +280,6 @@ else:
     config_filesystem(system, options)
 
 root = Root(full_system = False, system = system)
+if options.ruby:
+    Network.init_network_threads(options, root)
 Simulation.run(options, root, system, FutureClass)
@@ -68,13 +68,55 @@ def define_options(parser):
                       help="""routing algorithm in network.
                             0: weight-based table
                             1: XY (for Mesh. see garnet2.0/RoutingUnit.cc)
-                            2: Custom (see garnet2.0/RoutingUnit.cc""")
+                            2: Custom (see garnet2.0/RoutingUnit.cc)
+                            3: West-first adaptive (for Mesh)
+                            4: Odd-even adaptive (for Mesh)""")
     parser.add_option("--smart", action="store_true", default=False,
-                      help="Enable SMART (only SMART_1D supported currently)")
+                      help="Enable SMART (SMART_1D unless --smart_2d)")
     parser.add_option("--smart_hpcmax", type="int", default=4,
                       help="HPCmax for SMART")
     parser.add_option("--smart_dest_bypass", action="store_true", default=False,
                       help="Enable SMART destination bypass")
+    parser.add_option("--smart_2d", action="store_true", default=False,
+                      help="Enable SMART_2D (bypass through turns)")
+    parser.add_option("--smart_priority", type="int", default=0,
+                      help="""SSR priority among bypassing flits
+                            (local flits always win).
+                            0: closest source first
+                            1: farthest source first""")
+    parser.add_option("--network-threads", action="store", type="int",
+                      default=1,
+                      help="""number of host threads to simulate garnet
+                            routers on (no SMART). Routers are split
+                            into contiguous blocks of ids, one event
+                            queue each, with the link latency as the
+                            simulation quantum.""")
+    parser.add_option("--network-trace", action="store", type="string",
+                      default="",
+                      help="""record every packet injected into garnet
+                            to this file in the output directory (.gz to
+                            compress). Replay it with
+                            configs/example/garnet_trace_traffic.py""")
+    parser.add_option("--network-util-file", action="store", type="string",
+                      default="",
+                      help="""sample garnet router and link utilization
+                            to <file>.routers.csv and <file>.links.csv
+                            in the output directory (.gz to compress)""")
+    parser.add_option("--network-util-interval", action="store",
+                      type="int", default=10000,
+                      help="""utilization sampling interval, in network
+                            cycles""")
+    parser.add_option("--network-report", action="store", type="string",
+                      default="",
+                      help="""write garnet router heatmaps and the busiest
+                            links to this file in the output directory at
+                            the end of simulation (see also
+                            util/garnet_heatmap.py)""")
+    parser.add_option("--pair-latency-stats", action="store_true",
+                      default=False,
+                      help="""report garnet packet latency percentiles per
+                            source/destination NI pair, besides the ones
+                            per destination NI""")
     parser.add_option("--network-fault-model", action="store_true",
                       default=False,
                       help="""enable network fault model:
@@ -119,11 +161,20 @@ def init_network(options, network, InterfaceClass):
         network.enable_smart = options.smart
         network.smart_hpcmax = options.smart_hpcmax
         network.smart_dest_bypass = options.smart_dest_bypass
-
-    if options.smart:
+        network.smart_2d = options.smart_2d
+        network.smart_priority = options.smart_priority
+        network.trace_file = options.network_trace
+        network.util_file = options.network_util_file
+        network.util_interval = options.network_util_interval
+        network.report_file = options.network_report
+        network.pair_latency_stats = options.pair_latency_stats
+
+    # SMART needs direction-based routing; keep an adaptive algorithm
+    if options.smart and options.routing_algorithm not in [3, 4]:
         network.routing_algorithm = 1 # XY
 
-
+    if options.network == "garnet2.0" and options.network_threads > 1:
+        partition_network(options, network)
 
     if options.network == "simple":
         network.setup_buffers()
@@ -137,3 +188,32 @@ def init_network(options, network, InterfaceClass):
         assert(options.network == "garnet2.0")
         network.enable_fault_model = True
         network.fault_model = FaultModel()
+
+def partition_network(options, network):
+    # Routers (and the links they drive) go to event queues
+    # 0 .. network_threads - 1. NIs stay on the event queue of the
+    # controllers, so message buffers are only touched by one thread.
+    num_routers = len(network.routers)
+    def eventq(router):
+        return router.router_id * options.network_threads // num_routers
+
+    for router in network.routers:
+        router.eventq_index = eventq(router)
+
+    # A link runs on the event queue of the object feeding it
+    for link in network.int_links:
+        link.network_link.eventq_index = eventq(link.src_node)
+        link.credit_link.eventq_index = eventq(link.dst_node)
+
+    for link in network.ext_links:
+        # [0]: NI -> router, [1]: router -> NI
+        link.network_links[1].eventq_index = eventq(link.int_node)
+        link.credit_links[0].eventq_index = eventq(link.int_node)
+
+def init_network_threads(options, root):
+    # Routers on different event queues only talk through links,
+    # so they can run a link latency apart
+    if options.network == "garnet2.0" and options.network_threads > 1:
+        m5.ticks.fixGlobalFrequency()
+        root.sim_quantum = options.link_latency * m5.ticks.fromSeconds(
+            m5.util.convert.anyToLatency(options.ruby_clock))
@@ -204,6 +204,15 @@ class RefCountingPtr
     template <bool B = TisConst>
     RefCountingPtr(const NonConstT &r) { copy(r.data); }
 
+    /// Create a reference counting pointer to a base class from one
+    /// to a derived class.  Adds a reference.
+    template <class U, class = typename std::enable_if<
+                  std::is_convertible<U *, T *>::value &&
+                  !std::is_same<typename std::remove_const<T>::type,
+                                typename std::remove_const<U>::type>::value
+                  >::type>
+    RefCountingPtr(const RefCountingPtr<U> &r) { copy(r.get()); }
+
     /// Destroy the pointer and any reference it may hold.
     ~RefCountingPtr() { del(); }
 
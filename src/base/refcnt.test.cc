@@ -173,4 +173,19 @@ TEST(RefcntTest, EqualityOperators)
     EXPECT_TRUE(equalTestA != equalTestBPtr);
     EXPECT_TRUE(equalTestAPtr != equalTestB);
     EXPECT_TRUE(equalTestAPtr != equalTestBPtr);
-}
\ No newline at end of file
+}
+
+TEST(RefcntTest, ConversionToBaseClass)
+{
+    // A Ptr to a derived class converts to a Ptr to its base class and
+    // shares the reference count.
+    class DerivedRC : public TestRC {};
+    RefCountingPtr<DerivedRC> derivedPtr = new DerivedRC();
+    Ptr basePtr = derivedPtr;
+    EXPECT_EQ(1, liveListSize());
+    EXPECT_TRUE(basePtr.get() == derivedPtr.get());
+    derivedPtr = NULL;
+    EXPECT_EQ(1, liveListSize());
+    basePtr = NULL;
+    EXPECT_EQ(0, liveListSize());
+}
@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/testers/garnet_trace_traffic/GarnetTraceTraffic.hh"
+
+#include <algorithm>
+
+#include "base/logging.hh"
+#include "debug/GarnetTraceTraffic.hh"
+#include "mem/packet.hh"
+#include "mem/request.hh"
+#include "mem/ruby/network/garnet2.0/GarnetNetwork.hh"
+#include "sim/core.hh"
+#include "sim/sim_exit.hh"
+#include "sim/system.hh"
+
+using namespace std;
+
+static int numTraceTesters = 0;
+
+int GarnetTraceTraffic::numActive = 0;
+uint64_t GarnetTraceTraffic::numPacketsSent = 0;
+
+map<string, shared_ptr<GarnetTraceTraffic::TraceReader>>
+    GarnetTraceTraffic::readers;
+
+GarnetTraceTraffic::TraceReader::TraceReader(const string &filename,
+                                             int num_testers)
+    : trace(filename), freq(0), first(0), pending(num_testers)
+{
+    ProtoMessage::NetworkTraceHeader header_msg;
+    if (!trace.read(header_msg)) {
+        fatal("could not read the header of network trace %s\n",
+              filename);
+    }
+    freq = header_msg.tick_freq();
+
+    // The first packet of the trace is replayed at tick 0
+    ProtoMessage::NetworkTracePacket pkt;
+    if (trace.read(pkt)) {
+        first = pkt.tick();
+        pending[pkt.src_router() % pending.size()].push_back(pkt);
+    }
+}
+
+bool
+GarnetTraceTraffic::TraceReader::next(int tester,
+                                      ProtoMessage::NetworkTracePacket &pkt)
+{
+    const int num_testers = pending.size();
+    if (tester >= num_testers)
+        return false;
+
+    auto &queue = pending[tester];
+    while (queue.empty()) {
+        if (!trace.read(pkt))
+            return false;
+        const int owner = pkt.src_router() % num_testers;
+        if (owner == tester)
+            return true;
+        pending[owner].push_back(pkt);
+    }
+
+    pkt = queue.front();
+    queue.pop_front();
+    return true;
+}
+
+bool
+GarnetTraceTraffic::CpuPort::recvTimingResp(PacketPtr pkt)
+{
+    tester->completeRequest(pkt);
+    return true;
+}
+
+void
+GarnetTraceTraffic::CpuPort::recvReqRetry()
+{
+    tester->doRetry();
+}
+
+void
+GarnetTraceTraffic::sendPkt(PacketPtr pkt)
+{
+    if (!cachePort.sendTimingReq(pkt)) {
+        retryPkt = pkt; // RubyPort will retry sending
+    }
+    numPacketsSent++;
+}
+
+GarnetTraceTraffic::GarnetTraceTraffic(const Params *p)
+    : ClockedObject(p),
+      tickEvent([this]{ tick(); }, "GarnetTraceTraffic tick",
+                false, Event::CPU_Tick_Pri),
+      cachePort("GarnetTraceTraffic", this),
+      retryPkt(NULL),
+      blockSizeBits(p->block_offset),
+      numDestinations(p->num_dest),
+      dependency(p->dependency),
+      network(p->network),
+      haveNextPkt(true),
+      tickScale(1.0),
+      traceStart(0),
+      lastTraceTick(0),
+      lastInjectTick(0),
+      masterId(p->system->getMasterId(this))
+{
+    id = numTraceTesters++;
+    numActive++;
+
+    shared_ptr<TraceReader> &trace_reader = readers[p->trace_file];
+    if (!trace_reader)
+        trace_reader = make_shared<TraceReader>(p->trace_file,
+                                                numDestinations);
+    reader = trace_reader;
+    fatal_if(reader->numTesters() != numDestinations,
+             "%s: all the testers replaying %s need the same num_dest\n",
+             name(), p->trace_file);
+
+    tickScale = (double) SimClock::Frequency / reader->tickFreq();
+    traceStart = reader->start();
+    lastTraceTick = traceStart;
+    readNextPkt();
+
+    schedule(tickEvent, 0);
+
+    DPRINTF(GarnetTraceTraffic, "Config Created: Name = %s , and id = %d\n",
+            name(), id);
+}
+
+Port &
+GarnetTraceTraffic::getPort(const std::string &if_name, PortID idx)
+{
+    if (if_name == "test")
+        return cachePort;
+    else
+        return ClockedObject::getPort(if_name, idx);
+}
+
+void
+GarnetTraceTraffic::init()
+{
+    fatal_if(dependency && id >= network->getNumRouters(),
+             "%s: no router %d to throttle on\n", name(), id);
+}
+
+void
+GarnetTraceTraffic::completeRequest(PacketPtr pkt)
+{
+    DPRINTF(GarnetTraceTraffic,
+            "Completed injection of %s packet for address %x\n",
+            pkt->isWrite() ? "write" : "read\n",
+            pkt->req->getPaddr());
+
+    assert(pkt->isResponse());
+    delete pkt;
+}
+
+void
+GarnetTraceTraffic::tick()
+{
+    // At most one packet per cycle, and none while the port is busy
+    Tick when;
+    if (retryPkt == NULL && readyTick(when) && when <= curTick())
+        generatePkt();
+
+    if (haveNextPkt || retryPkt != NULL) {
+        // With open-loop replay, sleep until the next packet is due
+        Cycles delay(1);
+        if (retryPkt == NULL && readyTick(when) && when > curTick())
+            delay = max(Cycles(1), ticksToCycles(when - curTick()));
+        schedule(tickEvent, clockEdge(delay));
+    } else if (numActive == 0) {
+        // The last tester to finish waits for the packets in flight
+        if (networkDrained())
+            exitSimLoop("Network trace replay completed");
+        else
+            schedule(tickEvent, clockEdge(Cycles(1)));
+    }
+}
+
+// Advance to the next packet injected by this tester
+void
+GarnetTraceTraffic::readNextPkt()
+{
+    if (reader->next(id, nextPkt))
+        return;
+
+    haveNextPkt = false;
+    numActive--;
+}
+
+// Tick at which the next packet can be injected.
+// Returns false if it waits for packets to be received first.
+bool
+GarnetTraceTraffic::readyTick(Tick &when)
+{
+    if (!haveNextPkt)
+        return false;
+
+    if (!dependency) {
+        when = 0;
+        if (nextPkt.tick() > traceStart)
+            when = toTick(nextPkt.tick() - traceStart);
+        return true;
+    }
+
+    // Keep the recorded spacing to the previous packet of this tester
+    when = lastInjectTick;
+    if (nextPkt.tick() > lastTraceTick)
+        when += toTick(nextPkt.tick() - lastTraceTick);
+
+    uint64_t received = network->get_delivered_packets(id);
+    if (received < nextPkt.num_received())
+        return false;
+
+    // The gap counts from the packet this one waited for, which is the
+    // last one received unless more have arrived since
+    if (nextPkt.num_received() > 0 && received == nextPkt.num_received()) {
+        when = max(when, network->get_last_delivery(id) +
+                         toTick(nextPkt.gap()));
+    }
+    return true;
+}
+
+void
+GarnetTraceTraffic::generatePkt()
+{
+    // The destination bits are embedded in the address after byte-offset
+    // (see GarnetSyntheticTraffic::generatePkt)
+    Addr paddr = nextPkt.dest_router() % numDestinations;
+    paddr <<= blockSizeBits;
+    unsigned access_size = 1; // Does not affect Ruby simulation
+
+    // Garnet_standalone injects ReadReq, INST_FETCH and WriteReq into
+    // vnets 0, 1 and 2 respectively. Vnets 0 and 1 carry control packets
+    // (1-flit), vnet 2 carries data packets (5-flit).
+    MemCmd::Command requestType;
+    RequestPtr req = nullptr;
+    Request::Flags flags;
+
+    if (nextPkt.size() > 1) {
+        requestType = MemCmd::WriteReq;
+        req = std::make_shared<Request>(paddr, access_size, flags, masterId);
+    } else if (nextPkt.vnet() == 1) {
+        requestType = MemCmd::ReadReq;
+        flags.set(Request::INST_FETCH);
+        req = std::make_shared<Request>(
+            0, 0x0, access_size, flags, masterId, 0x0, 0);
+        req->setPaddr(paddr);
+    } else {
+        requestType = MemCmd::ReadReq;
+        req = std::make_shared<Request>(paddr, access_size, flags, masterId);
+    }
+
+    req->setContext(id);
+
+    DPRINTF(GarnetTraceTraffic,
+            "Replaying packet from router %d to router %d recorded at %d, "
+            "embedded in address %x\n",
+            nextPkt.src_router(), nextPkt.dest_router(), nextPkt.tick(),
+            req->getPaddr());
+
+    PacketPtr pkt = new Packet(req, requestType);
+    pkt->dataDynamic(new uint8_t[req->getSize()]);
+    pkt->senderState = NULL;
+
+    lastTraceTick = max(lastTraceTick, (uint64_t) nextPkt.tick());
+    lastInjectTick = curTick();
+
+    sendPkt(pkt);
+    readNextPkt();
+}
+
+// Every packet sent by the testers has been received
+bool
+GarnetTraceTraffic::networkDrained()
+{
+    uint64_t received = 0;
+    for (int i = 0; i < network->getNumRouters(); i++)
+        received += network->get_delivered_packets(i);
+    return received >= numPacketsSent;
+}
+
+void
+GarnetTraceTraffic::doRetry()
+{
+    if (cachePort.sendTimingReq(retryPkt)) {
+        retryPkt = NULL;
+    }
+}
+
+
+GarnetTraceTraffic *
+GarnetTraceTrafficParams::create()
+{
+    return new GarnetTraceTraffic(this);
+}
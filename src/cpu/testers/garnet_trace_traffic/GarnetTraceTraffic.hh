@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_GARNET_TRACE_TRAFFIC_HH__
+#define __CPU_GARNET_TRACE_TRAFFIC_HH__
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mem/port.hh"
+#include "params/GarnetTraceTraffic.hh"
+#include "proto/network_trace.pb.h"
+#include "proto/protoio.hh"
+#include "sim/clocked_object.hh"
+#include "sim/eventq.hh"
+
+class GarnetNetwork;
+class Packet;
+
+/*
+ * Replays a network trace recorded by GarnetNetwork (see
+ * src/proto/network_trace.proto) on the Garnet_standalone protocol,
+ * so that a network design can be evaluated on the traffic of a full
+ * system run without simulating the cores and caches again.
+ *
+ * There is one tester per router: the tester with id i injects the
+ * packets recorded at the routers r with (r % num_dest) == i, to the
+ * directory at router (dest_router % num_dest). Single-flit packets go
+ * to vnet 0 (or 1 if recorded there), multi-flit packets to vnet 2.
+ * The testers replaying the same trace share one reader of it.
+ *
+ * Packets are injected at their recorded time (open loop) or, with
+ * dependency throttling, not before the tester's router has received
+ * as many packets as the source router had when the packet was
+ * recorded, plus the recorded gap.
+ */
+class GarnetTraceTraffic : public ClockedObject
+{
+  public:
+    typedef GarnetTraceTrafficParams Params;
+    GarnetTraceTraffic(const Params *p);
+
+    void init() override;
+
+    // main simulation loop (one cycle)
+    void tick();
+
+    Port &getPort(const std::string &if_name,
+                  PortID idx=InvalidPortID) override;
+
+  protected:
+    EventFunctionWrapper tickEvent;
+
+    class CpuPort : public MasterPort
+    {
+        GarnetTraceTraffic *tester;
+
+      public:
+
+        CpuPort(const std::string &_name, GarnetTraceTraffic *_tester)
+            : MasterPort(_name, _tester), tester(_tester)
+        { }
+
+      protected:
+
+        virtual bool recvTimingResp(PacketPtr pkt);
+
+        virtual void recvReqRetry();
+    };
+
+    CpuPort cachePort;
+
+    /**
+     * Reads a trace once for all the testers replaying it, and hands
+     * each tester its own packets in trace order, holding on to the
+     * packets read for the other testers until they ask for them.
+     */
+    class TraceReader
+    {
+      public:
+        TraceReader(const std::string &filename, int num_testers);
+
+        /** Trace ticks per second */
+        uint64_t tickFreq() const { return freq; }
+        /** Trace tick of the first packet in the trace */
+        uint64_t start() const { return first; }
+        /** Number of testers the packets are handed to */
+        int numTesters() const { return pending.size(); }
+
+        /**
+         * Next packet of a tester.
+         * @return false if the tester has no packets left.
+         */
+        bool next(int tester, ProtoMessage::NetworkTracePacket &pkt);
+
+      private:
+        ProtoInputStream trace;
+        uint64_t freq;
+        uint64_t first;
+        std::vector<std::deque<ProtoMessage::NetworkTracePacket>> pending;
+    };
+
+    // The reader of each trace, by file name
+    static std::map<std::string, std::shared_ptr<TraceReader>> readers;
+    std::shared_ptr<TraceReader> reader;
+
+    PacketPtr retryPkt;
+    int id;
+
+    unsigned blockSizeBits;
+    int numDestinations;
+    bool dependency;
+
+    GarnetNetwork *network;
+
+    // Next packet of this tester, if any is left
+    ProtoMessage::NetworkTracePacket nextPkt;
+    bool haveNextPkt;
+
+    // Simulation ticks per trace tick
+    double tickScale;
+    Tick toTick(uint64_t trace_ticks) const { return trace_ticks * tickScale; }
+
+    // Trace tick of the first packet in the trace, replayed at tick 0
+    uint64_t traceStart;
+    // Trace tick and simulation tick of the last packet injected
+    uint64_t lastTraceTick;
+    Tick lastInjectTick;
+
+    MasterID masterId;
+
+    // Testers still replaying, and packets injected by all testers
+    static int numActive;
+    static uint64_t numPacketsSent;
+
+    void completeRequest(PacketPtr pkt);
+
+    void readNextPkt();
+    bool readyTick(Tick &when);
+    void generatePkt();
+    void sendPkt(PacketPtr pkt);
+    bool networkDrained();
+
+    void doRetry();
+};
+
+#endif // __CPU_GARNET_TRACE_TRAFFIC_HH__
@@ -135,6 +135,12 @@ class DRAMCtrl(QoSMemCtrl):
     # performance being lower when enabled
     enable_dram_powerdown = Param.Bool(False, "Enable powerdown states")
 
+    # Stop the refresh events of ranks while the controller is idle and
+    # account for the skipped refreshes in one go when the controller is
+    # next accessed, drained or has its stats dumped or reset. This only
+    # affects simulation speed, not the results
+    skip_idle_refresh = Param.Bool(False, "Skip refresh events while idle")
+
     # For power modelling we need to know if the DRAM has a DLL or not
     dll = Param.Bool(True, "DRAM has DLL or not")
 
@@ -132,6 +132,12 @@ class SnoopFilter(SimObject):
     # Sanity check on max capacity to track, adjust if needed.
     max_capacity = Param.MemorySize('8MB', "Maximum capacity of snoop filter")
 
+    # The lines of a region are kept together in the table of the
+    # filter, set to the page size for streams spanning whole pages.
+    # Lines are tracked individually regardless.
+    region_size = Param.MemorySize('512B', "Size of the regions grouped "
+                                   "together in the filter table")
+
 # We use a coherent crossbar to connect multiple masters to the L2
 # caches. Normally this crossbar would be part of the cache itself.
 class L2XBar(CoherentXBar):
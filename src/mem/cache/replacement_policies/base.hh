@@ -31,16 +31,77 @@
 #ifndef __MEM_CACHE_REPLACEMENT_POLICIES_BASE_HH__
 #define __MEM_CACHE_REPLACEMENT_POLICIES_BASE_HH__
 
+#include <cstddef>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "params/BaseReplacementPolicy.hh"
 #include "sim/sim_object.hh"
 
 /**
- * Replacement candidates as chosen by the indexing policy.
+ * Storage for the replacement data of a policy. Rather than allocating the
+ * data of every entry (and its reference count) separately, the data are
+ * constructed in allocation order into contiguous chunks, and the pointer
+ * handed to each entry shares the ownership of its whole chunk. The tags
+ * instantiate their entries set by set, so the data of the ways of a set
+ * usually lie next to each other, and can be scanned as a plain array.
  */
-typedef std::vector<ReplaceableEntry*> ReplacementCandidates;
+template <class Data>
+class ReplacementDataPool
+{
+  private:
+    /**
+     * Number of entries of a chunk. A power of two, so that the sets of
+     * a power of two associativity never straddle two chunks.
+     */
+    static const std::size_t chunkSize = 1024;
+
+    /** The chunk new data are constructed into. */
+    std::shared_ptr<std::vector<Data>> chunk;
+
+  public:
+    /**
+     * Construct the replacement data of a new entry.
+     *
+     * @param args Arguments of the data constructor.
+     * @return A shared pointer to the new replacement data.
+     */
+    template <class... Args>
+    std::shared_ptr<ReplacementData>
+    allocate(Args&&... args)
+    {
+        if (!chunk || chunk->size() == chunkSize) {
+            chunk = std::make_shared<std::vector<Data>>();
+            chunk->reserve(chunkSize);
+        }
+        chunk->emplace_back(std::forward<Args>(args)...);
+        return std::shared_ptr<ReplacementData>(chunk, &chunk->back());
+    }
+
+    /**
+     * Get the replacement data of the candidates as an array, if they lie
+     * consecutively in the same order as the candidates.
+     *
+     * @param candidates Replacement candidates, whose data were allocated
+     *                   by this pool.
+     * @return The data of the first candidate, or nullptr if the data are
+     *         not consecutive.
+     */
+    static const Data*
+    span(const ReplacementCandidates& candidates)
+    {
+        const Data* first = static_cast<const Data*>(
+            candidates[0]->replacementData.get());
+        for (std::size_t i = 1; i < candidates.size(); i++) {
+            if (candidates[i]->replacementData.get() != first + i) {
+                return nullptr;
+            }
+        }
+        return first;
+    }
+};
 
 /**
  * A common base class of cache replacement policy objects.
@@ -48,8 +48,8 @@ void
 BRRIPRP::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
 const
 {
-    std::shared_ptr<BRRIPReplData> casted_replacement_data =
-        std::static_pointer_cast<BRRIPReplData>(replacement_data);
+    BRRIPReplData* casted_replacement_data =
+        static_cast<BRRIPReplData*>(replacement_data.get());
 
     // Invalidate entry
     casted_replacement_data->valid = false;
@@ -58,8 +58,8 @@ const
 void
 BRRIPRP::touch(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
-    std::shared_ptr<BRRIPReplData> casted_replacement_data =
-        std::static_pointer_cast<BRRIPReplData>(replacement_data);
+    BRRIPReplData* casted_replacement_data =
+        static_cast<BRRIPReplData*>(replacement_data.get());
 
     // Update RRPV if not 0 yet
     // Every hit in HP mode makes the entry the last to be evicted, while
@@ -74,8 +74,8 @@ BRRIPRP::touch(const std::shared_ptr<ReplacementData>& replacement_data) const
 void
 BRRIPRP::reset(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
-    std::shared_ptr<BRRIPReplData> casted_replacement_data =
-        std::static_pointer_cast<BRRIPReplData>(replacement_data);
+    BRRIPReplData* casted_replacement_data =
+        static_cast<BRRIPReplData*>(replacement_data.get());
 
     // Reset RRPV
     // Replacement data is inserted as "long re-reference" if lower than btp,
@@ -99,39 +99,59 @@ BRRIPRP::getVictim(const ReplacementCandidates& candidates) const
     ReplaceableEntry* victim = candidates[0];
 
     // Store victim->rrpv in a variable to improve code readability
-    int victim_RRPV = std::static_pointer_cast<BRRIPReplData>(
-                        victim->replacementData)->rrpv;
-
-    // Visit all candidates to find victim
-    for (const auto& candidate : candidates) {
-        std::shared_ptr<BRRIPReplData> candidate_repl_data =
-            std::static_pointer_cast<BRRIPReplData>(
-                candidate->replacementData);
-
-        // Stop searching for victims if an invalid entry is found
-        if (!candidate_repl_data->valid) {
-            return candidate;
+    int victim_RRPV = static_cast<BRRIPReplData*>(
+                        victim->replacementData.get())->rrpv;
+
+    // The data of the ways of a set are usually consecutive in the pool, in
+    // which case they are scanned as an array
+    const BRRIPReplData* data =
+        ReplacementDataPool<BRRIPReplData>::span(candidates);
+    if (data) {
+        for (std::size_t i = 0; i < candidates.size(); i++) {
+            // Stop searching for victims if an invalid entry is found
+            if (!data[i].valid) {
+                return candidates[i];
+            }
+
+            // Update victim entry if necessary
+            int candidate_RRPV = data[i].rrpv;
+            if (candidate_RRPV > victim_RRPV) {
+                victim = candidates[i];
+                victim_RRPV = candidate_RRPV;
+            }
         }
-
-        // Update victim entry if necessary
-        int candidate_RRPV = candidate_repl_data->rrpv;
-        if (candidate_RRPV > victim_RRPV) {
-            victim = candidate;
-            victim_RRPV = candidate_RRPV;
+    } else {
+        // Visit all candidates to find victim
+        for (const auto& candidate : candidates) {
+            BRRIPReplData* candidate_repl_data =
+                static_cast<BRRIPReplData*>(
+                    candidate->replacementData.get());
+
+            // Stop searching for victims if an invalid entry is found
+            if (!candidate_repl_data->valid) {
+                return candidate;
+            }
+
+            // Update victim entry if necessary
+            int candidate_RRPV = candidate_repl_data->rrpv;
+            if (candidate_RRPV > victim_RRPV) {
+                victim = candidate;
+                victim_RRPV = candidate_RRPV;
+            }
         }
     }
 
     // Get difference of victim's RRPV to the highest possible RRPV in
     // order to update the RRPV of all the other entries accordingly
-    int diff = std::static_pointer_cast<BRRIPReplData>(
-        victim->replacementData)->rrpv.saturate();
+    int diff = static_cast<BRRIPReplData*>(
+        victim->replacementData.get())->rrpv.saturate();
 
     // No need to update RRPV if there is no difference
     if (diff > 0){
         // Update RRPV of all candidates
         for (const auto& candidate : candidates) {
-            std::static_pointer_cast<BRRIPReplData>(
-                candidate->replacementData)->rrpv += diff;
+            static_cast<BRRIPReplData*>(
+                candidate->replacementData.get())->rrpv += diff;
         }
     }
 
@@ -141,7 +161,7 @@ BRRIPRP::getVictim(const ReplacementCandidates& candidates) const
 std::shared_ptr<ReplacementData>
 BRRIPRP::instantiateEntry()
 {
-    return std::shared_ptr<ReplacementData>(new BRRIPReplData(numRRPVBits));
+    return replacementDataPool.allocate(numRRPVBits);
 }
 
 BRRIPRP*
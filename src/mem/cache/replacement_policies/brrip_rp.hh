@@ -86,6 +86,9 @@ class BRRIPRP : public BaseReplacementPolicy
         }
     };
 
+    /** Contiguous storage of the replacement data of the entries. */
+    ReplacementDataPool<BRRIPReplData> replacementDataPool;
+
     /**
      * Number of RRPV bits. An entry that saturates its RRPV has the longest
      * possible re-reference interval, that is, it is likely not to be used
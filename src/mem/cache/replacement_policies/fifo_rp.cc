@@ -45,8 +45,8 @@ FIFORP::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
 const
 {
     // Reset insertion tick
-    std::static_pointer_cast<FIFOReplData>(
-        replacement_data)->tickInserted = Tick(0);
+    static_cast<FIFOReplData*>(
+        replacement_data.get())->tickInserted = Tick(0);
 }
 
 void
@@ -59,8 +59,8 @@ void
 FIFORP::reset(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
     // Set insertion tick
-    std::static_pointer_cast<FIFOReplData>(
-        replacement_data)->tickInserted = curTick();
+    static_cast<FIFOReplData*>(
+        replacement_data.get())->tickInserted = curTick();
 }
 
 ReplaceableEntry*
@@ -73,10 +73,10 @@ FIFORP::getVictim(const ReplacementCandidates& candidates) const
     ReplaceableEntry* victim = candidates[0];
     for (const auto& candidate : candidates) {
         // Update victim entry if necessary
-        if (std::static_pointer_cast<FIFOReplData>(
-                    candidate->replacementData)->tickInserted <
-                std::static_pointer_cast<FIFOReplData>(
-                    victim->replacementData)->tickInserted) {
+        if (static_cast<FIFOReplData*>(
+                    candidate->replacementData.get())->tickInserted <
+                static_cast<FIFOReplData*>(
+                    victim->replacementData.get())->tickInserted) {
             victim = candidate;
         }
     }
@@ -87,7 +87,7 @@ FIFORP::getVictim(const ReplacementCandidates& candidates) const
 std::shared_ptr<ReplacementData>
 FIFORP::instantiateEntry()
 {
-    return std::shared_ptr<ReplacementData>(new FIFOReplData());
+    return replacementDataPool.allocate();
 }
 
 FIFORP*
@@ -58,6 +58,9 @@ class FIFORP : public BaseReplacementPolicy
         FIFOReplData() : tickInserted(0) {}
     };
 
+    /** Contiguous storage of the replacement data of the entries. */
+    ReplacementDataPool<FIFOReplData> replacementDataPool;
+
   public:
     /** Convenience typedef. */
     typedef FIFORPParams Params;
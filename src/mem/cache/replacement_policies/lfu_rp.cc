@@ -30,6 +30,7 @@
 
 #include "mem/cache/replacement_policies/lfu_rp.hh"
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 
@@ -45,21 +46,21 @@ LFURP::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
 const
 {
     // Reset reference count
-    std::static_pointer_cast<LFUReplData>(replacement_data)->refCount = 0;
+    static_cast<LFUReplData*>(replacement_data.get())->refCount = 0;
 }
 
 void
 LFURP::touch(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
     // Update reference count
-    std::static_pointer_cast<LFUReplData>(replacement_data)->refCount++;
+    static_cast<LFUReplData*>(replacement_data.get())->refCount++;
 }
 
 void
 LFURP::reset(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
     // Reset reference count
-    std::static_pointer_cast<LFUReplData>(replacement_data)->refCount = 1;
+    static_cast<LFUReplData*>(replacement_data.get())->refCount = 1;
 }
 
 ReplaceableEntry*
@@ -68,14 +69,31 @@ LFURP::getVictim(const ReplacementCandidates& candidates) const
     // There must be at least one replacement candidate
     assert(candidates.size() > 0);
 
+    // The data of the ways of a set are usually consecutive in the pool, in
+    // which case the counts are scanned as an array: find the lowest count
+    // first, and then the first candidate that holds it
+    const LFUReplData* data =
+        ReplacementDataPool<LFUReplData>::span(candidates);
+    if (data) {
+        unsigned min_count = data[0].refCount;
+        for (std::size_t i = 1; i < candidates.size(); i++) {
+            min_count = std::min(min_count, data[i].refCount);
+        }
+        std::size_t victim_idx = 0;
+        while (data[victim_idx].refCount != min_count) {
+            victim_idx++;
+        }
+        return candidates[victim_idx];
+    }
+
     // Visit all candidates to find victim
     ReplaceableEntry* victim = candidates[0];
     for (const auto& candidate : candidates) {
         // Update victim entry if necessary
-        if (std::static_pointer_cast<LFUReplData>(
-                    candidate->replacementData)->refCount <
-                std::static_pointer_cast<LFUReplData>(
-                    victim->replacementData)->refCount) {
+        if (static_cast<LFUReplData*>(
+                    candidate->replacementData.get())->refCount <
+                static_cast<LFUReplData*>(
+                    victim->replacementData.get())->refCount) {
             victim = candidate;
         }
     }
@@ -86,7 +104,7 @@ LFURP::getVictim(const ReplacementCandidates& candidates) const
 std::shared_ptr<ReplacementData>
 LFURP::instantiateEntry()
 {
-    return std::shared_ptr<ReplacementData>(new LFUReplData());
+    return replacementDataPool.allocate();
 }
 
 LFURP*
@@ -58,6 +58,9 @@ class LFURP : public BaseReplacementPolicy
         LFUReplData() : refCount(0) {}
     };
 
+    /** Contiguous storage of the replacement data of the entries. */
+    ReplacementDataPool<LFUReplData> replacementDataPool;
+
   public:
     /** Convenience typedef. */
     typedef LFURPParams Params;
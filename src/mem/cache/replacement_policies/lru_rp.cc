@@ -30,6 +30,7 @@
 
 #include "mem/cache/replacement_policies/lru_rp.hh"
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 
@@ -45,24 +46,24 @@ LRURP::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
 const
 {
     // Reset last touch timestamp
-    std::static_pointer_cast<LRUReplData>(
-        replacement_data)->lastTouchTick = Tick(0);
+    static_cast<LRUReplData*>(
+        replacement_data.get())->lastTouchTick = Tick(0);
 }
 
 void
 LRURP::touch(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
     // Update last touch timestamp
-    std::static_pointer_cast<LRUReplData>(
-        replacement_data)->lastTouchTick = curTick();
+    static_cast<LRUReplData*>(
+        replacement_data.get())->lastTouchTick = curTick();
 }
 
 void
 LRURP::reset(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
     // Set last touch timestamp
-    std::static_pointer_cast<LRUReplData>(
-        replacement_data)->lastTouchTick = curTick();
+    static_cast<LRUReplData*>(
+        replacement_data.get())->lastTouchTick = curTick();
 }
 
 ReplaceableEntry*
@@ -71,14 +72,31 @@ LRURP::getVictim(const ReplacementCandidates& candidates) const
     // There must be at least one replacement candidate
     assert(candidates.size() > 0);
 
+    // The data of the ways of a set are usually consecutive in the pool, in
+    // which case the timestamps are scanned as an array: find the oldest
+    // timestamp first, and then the first candidate that holds it
+    const LRUReplData* data =
+        ReplacementDataPool<LRUReplData>::span(candidates);
+    if (data) {
+        Tick oldest_tick = data[0].lastTouchTick;
+        for (std::size_t i = 1; i < candidates.size(); i++) {
+            oldest_tick = std::min(oldest_tick, data[i].lastTouchTick);
+        }
+        std::size_t victim_idx = 0;
+        while (data[victim_idx].lastTouchTick != oldest_tick) {
+            victim_idx++;
+        }
+        return candidates[victim_idx];
+    }
+
     // Visit all candidates to find victim
     ReplaceableEntry* victim = candidates[0];
     for (const auto& candidate : candidates) {
         // Update victim entry if necessary
-        if (std::static_pointer_cast<LRUReplData>(
-                    candidate->replacementData)->lastTouchTick <
-                std::static_pointer_cast<LRUReplData>(
-                    victim->replacementData)->lastTouchTick) {
+        if (static_cast<LRUReplData*>(
+                    candidate->replacementData.get())->lastTouchTick <
+                static_cast<LRUReplData*>(
+                    victim->replacementData.get())->lastTouchTick) {
             victim = candidate;
         }
     }
@@ -89,7 +107,7 @@ LRURP::getVictim(const ReplacementCandidates& candidates) const
 std::shared_ptr<ReplacementData>
 LRURP::instantiateEntry()
 {
-    return std::shared_ptr<ReplacementData>(new LRUReplData());
+    return replacementDataPool.allocate();
 }
 
 LRURP*
@@ -56,6 +56,9 @@ class LRURP : public BaseReplacementPolicy
         LRUReplData() : lastTouchTick(0) {}
     };
 
+    /** Contiguous storage of the replacement data of the entries. */
+    ReplacementDataPool<LRUReplData> replacementDataPool;
+
   public:
     /** Convenience typedef. */
     typedef LRURPParams Params;
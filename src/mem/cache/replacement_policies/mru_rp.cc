@@ -45,24 +45,24 @@ MRURP::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
 const
 {
     // Reset last touch timestamp
-    std::static_pointer_cast<MRUReplData>(
-        replacement_data)->lastTouchTick = Tick(0);
+    static_cast<MRUReplData*>(
+        replacement_data.get())->lastTouchTick = Tick(0);
 }
 
 void
 MRURP::touch(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
     // Update last touch timestamp
-    std::static_pointer_cast<MRUReplData>(
-        replacement_data)->lastTouchTick = curTick();
+    static_cast<MRUReplData*>(
+        replacement_data.get())->lastTouchTick = curTick();
 }
 
 void
 MRURP::reset(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
     // Set last touch timestamp
-    std::static_pointer_cast<MRUReplData>(
-        replacement_data)->lastTouchTick = curTick();
+    static_cast<MRUReplData*>(
+        replacement_data.get())->lastTouchTick = curTick();
 }
 
 ReplaceableEntry*
@@ -74,16 +74,16 @@ MRURP::getVictim(const ReplacementCandidates& candidates) const
     // Visit all candidates to find victim
     ReplaceableEntry* victim = candidates[0];
     for (const auto& candidate : candidates) {
-        std::shared_ptr<MRUReplData> candidate_replacement_data =
-            std::static_pointer_cast<MRUReplData>(candidate->replacementData);
+        MRUReplData* candidate_replacement_data =
+            static_cast<MRUReplData*>(candidate->replacementData.get());
 
         // Stop searching entry if a cache line that doesn't warm up is found.
         if (candidate_replacement_data->lastTouchTick == 0) {
             victim = candidate;
             break;
         } else if (candidate_replacement_data->lastTouchTick >
-                std::static_pointer_cast<MRUReplData>(
-                    victim->replacementData)->lastTouchTick) {
+                static_cast<MRUReplData*>(
+                    victim->replacementData.get())->lastTouchTick) {
             victim = candidate;
         }
     }
@@ -94,7 +94,7 @@ MRURP::getVictim(const ReplacementCandidates& candidates) const
 std::shared_ptr<ReplacementData>
 MRURP::instantiateEntry()
 {
-    return std::shared_ptr<ReplacementData>(new MRUReplData());
+    return replacementDataPool.allocate();
 }
 
 MRURP*
@@ -58,6 +58,9 @@ class MRURP : public BaseReplacementPolicy
         MRUReplData() : lastTouchTick(0) {}
     };
 
+    /** Contiguous storage of the replacement data of the entries. */
+    ReplacementDataPool<MRUReplData> replacementDataPool;
+
   public:
     /** Convenience typedef. */
     typedef MRURPParams Params;
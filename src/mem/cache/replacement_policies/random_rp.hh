@@ -59,6 +59,9 @@ class RandomRP : public BaseReplacementPolicy
         RandomReplData() : valid(false) {}
     };
 
+    /** Contiguous storage of the replacement data of the entries. */
+    ReplacementDataPool<RandomReplData> replacementDataPool;
+
   public:
     /** Convenience typedef. */
     typedef RandomRPParams Params;
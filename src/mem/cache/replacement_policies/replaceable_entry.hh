@@ -31,8 +31,11 @@
 #ifndef __MEM_CACHE_REPLACEMENT_POLICIES_REPLACEABLE_ENTRY_HH__
 #define __MEM_CACHE_REPLACEMENT_POLICIES_REPLACEABLE_ENTRY_HH__
 
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 /**
  * The replacement data needed by replacement policies. Each replacement policy
@@ -101,4 +104,52 @@ class ReplaceableEntry
     uint32_t getWay() const { return _way; }
 };
 
+/**
+ * Replacement candidates as chosen by the indexing policy. This is a
+ * non-owning view of a contiguous array of entry pointers, so handing the
+ * candidates of a lookup to the tags and to the replacement policy does not
+ * copy or allocate anything. The storage belongs to whoever produced the
+ * view (usually the indexing policy), and the view is only valid until that
+ * storage is next modified.
+ */
+class ReplacementCandidates
+{
+  public:
+    typedef ReplaceableEntry* const* const_iterator;
+
+    ReplacementCandidates() : entries(nullptr), numEntries(0) {}
+
+    ReplacementCandidates(ReplaceableEntry* const* entries,
+                          const std::size_t num_entries)
+      : entries(entries), numEntries(num_entries)
+    {
+    }
+
+    /** Build a view over all the entries of the given vector. */
+    ReplacementCandidates(const std::vector<ReplaceableEntry*>& entries)
+      : entries(entries.data()), numEntries(entries.size())
+    {
+    }
+
+    const_iterator begin() const { return entries; }
+    const_iterator end() const { return entries + numEntries; }
+
+    std::size_t size() const { return numEntries; }
+    bool empty() const { return numEntries == 0; }
+
+    ReplaceableEntry*
+    operator[](const std::size_t idx) const
+    {
+        assert(idx < numEntries);
+        return entries[idx];
+    }
+
+  private:
+    /** First entry of the viewed array. */
+    ReplaceableEntry* const* entries;
+
+    /** Number of entries in the viewed array. */
+    std::size_t numEntries;
+};
+
 #endif // __MEM_CACHE_REPLACEMENT_POLICIES_REPLACEABLE_ENTRY_HH_
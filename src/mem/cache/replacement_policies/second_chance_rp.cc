@@ -57,8 +57,8 @@ SecondChanceRP::invalidate(
     FIFORP::invalidate(replacement_data);
 
     // Do not give a second chance to invalid entries
-    std::static_pointer_cast<SecondChanceReplData>(
-        replacement_data)->hasSecondChance = false;
+    static_cast<SecondChanceReplData*>(
+        replacement_data.get())->hasSecondChance = false;
 }
 
 void
@@ -68,8 +68,8 @@ SecondChanceRP::touch(const std::shared_ptr<ReplacementData>&
     FIFORP::touch(replacement_data);
 
     // Whenever an entry is touched, it is given a second chance
-    std::static_pointer_cast<SecondChanceReplData>(
-        replacement_data)->hasSecondChance = true;
+    static_cast<SecondChanceReplData*>(
+        replacement_data.get())->hasSecondChance = true;
 }
 
 void
@@ -79,8 +79,8 @@ SecondChanceRP::reset(const std::shared_ptr<ReplacementData>&
     FIFORP::reset(replacement_data);
 
     // Entries are inserted with a second chance
-    std::static_pointer_cast<SecondChanceReplData>(
-        replacement_data)->hasSecondChance = false;
+    static_cast<SecondChanceReplData*>(
+        replacement_data.get())->hasSecondChance = false;
 }
 
 ReplaceableEntry*
@@ -92,9 +92,9 @@ SecondChanceRP::getVictim(const ReplacementCandidates& candidates) const
     // Search for invalid entries, as they have the eviction priority
     for (const auto& candidate : candidates) {
         // Cast candidate's replacement data
-        std::shared_ptr<SecondChanceReplData> candidate_replacement_data =
-            std::static_pointer_cast<SecondChanceReplData>(
-                candidate->replacementData);
+        SecondChanceReplData* candidate_replacement_data =
+            static_cast<SecondChanceReplData*>(
+                candidate->replacementData.get());
 
         // Stop iteration if found an invalid entry
         if ((candidate_replacement_data->tickInserted == Tick(0)) &&
@@ -130,7 +130,7 @@ SecondChanceRP::getVictim(const ReplacementCandidates& candidates) const
 std::shared_ptr<ReplacementData>
 SecondChanceRP::instantiateEntry()
 {
-    return std::shared_ptr<ReplacementData>(new SecondChanceReplData());
+    return replacementDataPool.allocate();
 }
 
 SecondChanceRP*
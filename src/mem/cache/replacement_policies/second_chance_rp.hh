@@ -64,6 +64,9 @@ class SecondChanceRP : public FIFORP
         SecondChanceReplData() : FIFOReplData(), hasSecondChance(false) {}
     };
 
+    /** Contiguous storage of the replacement data of the entries. */
+    ReplacementDataPool<SecondChanceReplData> replacementDataPool;
+
     /**
      * Use replacement data's second chance.
      *
@@ -52,11 +52,10 @@
 
 #include <vector>
 
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "params/BaseIndexingPolicy.hh"
 #include "sim/sim_object.hh"
 
-class ReplaceableEntry;
-
 /**
  * A common base class for indexing table locations. Classes that inherit
  * from it determine hash functions that should be applied based on the set
@@ -143,10 +142,14 @@ class BaseIndexingPolicy : public SimObject
      * Should be called immediately before ReplacementPolicy's findVictim()
      * not to break cache resizing.
      *
+     * The returned view refers to storage owned by this policy, so finding
+     * the candidates of a lookup never allocates. It is only valid until the
+     * next call to this function.
+     *
      * @param addr The addr to a find possible entries for.
      * @return The possible entries.
      */
-    virtual std::vector<ReplaceableEntry*> getPossibleEntries(const Addr addr)
+    virtual ReplacementCandidates getPossibleEntries(const Addr addr)
                                                                     const = 0;
 
     /**
@@ -69,10 +69,10 @@ SetAssociative::regenerateAddr(const Addr tag, const ReplaceableEntry* entry)
     return (tag << tagShift) | (entry->getSet() << setShift);
 }
 
-std::vector<ReplaceableEntry*>
+ReplacementCandidates
 SetAssociative::getPossibleEntries(const Addr addr) const
 {
-    return sets[extractSet(addr)];
+    return ReplacementCandidates(sets[extractSet(addr)]);
 }
 
 SetAssociative*
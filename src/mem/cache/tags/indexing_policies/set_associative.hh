@@ -115,7 +115,7 @@ class SetAssociative : public BaseIndexingPolicy
      * @param addr The addr to a find possible entries for.
      * @return The possible entries.
      */
-    std::vector<ReplaceableEntry*> getPossibleEntries(const Addr addr) const
+    ReplacementCandidates getPossibleEntries(const Addr addr) const
                                                                      override;
 
     /**
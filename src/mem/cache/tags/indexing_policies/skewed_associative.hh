@@ -84,6 +84,13 @@ class SkewedAssociative : public BaseIndexingPolicy
      */
     const int msbShift;
 
+    /**
+     * Scratch storage of the candidates of the last lookup, sized to the
+     * associativity on construction so that lookups never allocate.
+     * @sa getPossibleEntries().
+     */
+    mutable std::vector<ReplaceableEntry*> candidates;
+
     /**
      * The hash function itself. Uses the hash function H, as described in
      * "Skewed-Associative Caches", from Seznec et al. (section 3.3): It
@@ -159,7 +166,7 @@ class SkewedAssociative : public BaseIndexingPolicy
      * @param addr The addr to a find possible entries for.
      * @return The possible entries.
      */
-    std::vector<ReplaceableEntry*> getPossibleEntries(const Addr addr) const
+    ReplacementCandidates getPossibleEntries(const Addr addr) const
                                                                    override;
 
     /**
@@ -204,7 +204,7 @@ SectorTags::findBlock(Addr addr, bool is_secure) const
     const Addr offset = extractSectorOffset(addr);
 
     // Find all possible sector entries that may contain the given address
-    const std::vector<ReplaceableEntry*> entries =
+    const ReplacementCandidates entries =
         indexingPolicy->getPossibleEntries(addr);
 
     // Search for block
@@ -225,7 +225,7 @@ SectorTags::findVictim(Addr addr, const bool is_secure, const std::size_t size,
                        std::vector<CacheBlk*>& evict_blks) const
 {
     // Get possible entries to be victimized
-    const std::vector<ReplaceableEntry*> sector_entries =
+    const ReplacementCandidates sector_entries =
         indexingPolicy->getPossibleEntries(addr);
 
     // Check if the sector this address belongs to has been allocated
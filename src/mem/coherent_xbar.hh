@@ -316,7 +316,8 @@ class CoherentXBar : public BaseXBar
     void
     forwardTiming(PacketPtr pkt, PortID exclude_slave_port_id)
     {
-        forwardTiming(pkt, exclude_slave_port_id, snoopPorts);
+        forwardTiming(pkt, exclude_slave_port_id,
+                      SnoopFilter::SnoopTargets(snoopPorts));
     }
 
     /**
@@ -326,10 +327,10 @@ class CoherentXBar : public BaseXBar
      *
      * @param pkt Packet to forward
      * @param exclude_slave_port_id Id of slave port to exclude
-     * @param dests Vector of destination ports for the forwarded pkt
+     * @param dests Destination ports for the forwarded pkt
      */
     void forwardTiming(PacketPtr pkt, PortID exclude_slave_port_id,
-                       const std::vector<QueuedSlavePort*>& dests);
+                       const SnoopFilter::SnoopTargets& dests);
 
     Tick recvAtomicBackdoor(PacketPtr pkt, PortID slave_port_id,
                             MemBackdoorPtr *backdoor=nullptr);
@@ -349,7 +350,7 @@ class CoherentXBar : public BaseXBar
     forwardAtomic(PacketPtr pkt, PortID exclude_slave_port_id)
     {
         return forwardAtomic(pkt, exclude_slave_port_id, InvalidPortID,
-                             snoopPorts);
+                             SnoopFilter::SnoopTargets(snoopPorts));
     }
 
     /**
@@ -360,14 +361,14 @@ class CoherentXBar : public BaseXBar
      * @param pkt Packet to forward
      * @param exclude_slave_port_id Id of slave port to exclude
      * @param source_master_port_id Id of the master port for snoops from below
-     * @param dests Vector of destination ports for the forwarded pkt
+     * @param dests Destination ports for the forwarded pkt
      *
      * @return a pair containing the snoop response and snoop latency
      */
     std::pair<MemCmd, Tick> forwardAtomic(PacketPtr pkt,
                                           PortID exclude_slave_port_id,
                                           PortID source_master_port_id,
-                                          const std::vector<QueuedSlavePort*>&
+                                          const SnoopFilter::SnoopTargets&
                                           dests);
 
     /** Function called by the port when the crossbar is recieving a Functional
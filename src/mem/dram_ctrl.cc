@@ -99,7 +99,8 @@ DRAMCtrl::DRAMCtrl(const DRAMCtrlParams* p) :
     nextReqTime(0),
     stats(*this),
     activeRank(0), timeStampOffset(0),
-    lastStatsResetTick(0), enableDRAMPowerdown(p->enable_dram_powerdown)
+    lastStatsResetTick(0), enableDRAMPowerdown(p->enable_dram_powerdown),
+    skipIdleRefresh(p->skip_idle_refresh)
 {
     // sanity check the ranks since we rely on bit slicing for the
     // address decoding
@@ -108,8 +109,10 @@ DRAMCtrl::DRAMCtrl(const DRAMCtrlParams* p) :
 
     fatal_if(!isPowerOf2(burstSize), "DRAM burst size %d is not allowed, "
              "must be a power of two\n", burstSize);
-    readQueue.resize(p->qos_priorities);
-    writeQueue.resize(p->qos_priorities);
+    readQueue.assign(p->qos_priorities,
+                     DRAMPacketQueue(ranksPerChannel * banksPerRank));
+    writeQueue.assign(p->qos_priorities,
+                      DRAMPacketQueue(ranksPerChannel * banksPerRank));
 
 
     for (int i = 0; i < ranksPerChannel; i++) {
@@ -595,6 +598,10 @@ DRAMCtrl::recvTimingReq(PacketPtr pkt)
     panic_if(!(pkt->isRead() || pkt->isWrite()),
              "Should only see read and writes at memory controller\n");
 
+    // the ranks have to be up to date before the request changes
+    // anything about them
+    catchUpRefreshes();
+
     // Calc avg gap between requests
     if (prevArrival != 0) {
         stats.totGap += curTick() - prevArrival;
@@ -776,111 +783,102 @@ DRAMCtrl::chooseNext(DRAMPacketQueue& queue, Tick extra_col_delay)
 DRAMCtrl::DRAMPacketQueue::iterator
 DRAMCtrl::chooseNextFRFCFS(DRAMPacketQueue& queue, Tick extra_col_delay)
 {
-    // Only determine this if needed
-    vector<uint32_t> earliest_banks(ranksPerChannel, 0);
-
-    // Has minBankPrep been called to populate earliest_banks?
-    bool filled_earliest_banks = false;
-    // can the PRE/ACT sequence be done without impacting utlization?
-    bool hidden_bank_prep = false;
-
-    // search for seamless row hits first, if no seamless row hit is
-    // found then determine if there are other packets that can be issued
-    // without incurring additional bus delay due to bank timing
-    // Will select closed rows first to enable more open row possibilies
-    // in future selections
-    bool found_hidden_bank = false;
-
-    // remember if we found a row hit, not seamless, but bank prepped
-    // and ready
-    bool found_prepped_pkt = false;
-
-    // if we have no row hit, prepped or not, and no seamless packet,
-    // just go for the earliest possible
-    bool found_earliest_pkt = false;
-
-    auto selected_pkt_it = queue.end();
+    // The packet selected is the one a walk of the queue in arrival
+    // order would pick: the first seamless row hit if there is one,
+    // else the first row hit to a prepped bank, unless a packet to a
+    // closed row can issue its bank commands without impacting
+    // utilization, in which case the first such packet amongst the
+    // earliest banks to be ready. As row hits and readiness only depend
+    // on the bank, it is enough to look at the first row hit and the
+    // first row miss of every bank, and compare their arrival order.
+    // There is no per-row index, so finding the first row hit of a bank
+    // still walks its packets: with every packet to one bank and none to
+    // the open row, a decision costs O(queue size) as before.
+
+    // first seamless row hit, and first row hit that is not seamless
+    // but bank prepped and ready
+    DRAMPacket* seamless_pkt = nullptr;
+    DRAMPacket* prepped_pkt = nullptr;
 
     // time we need to issue a column command to be seamless
     const Tick min_col_at = std::max(nextBurstAt + extra_col_delay, curTick());
 
-    for (auto i = queue.begin(); i != queue.end() ; ++i) {
-        DRAMPacket* dram_pkt = *i;
-        const Bank& bank = dram_pkt->bankRef;
-        const Tick col_allowed_at = dram_pkt->isRead() ? bank.rdAllowedAt :
-                                                         bank.wrAllowedAt;
-
-        DPRINTF(DRAM, "%s checking packet in bank %d\n",
-                __func__, dram_pkt->bankRef.bank);
+    for (uint16_t bank_id = 0; bank_id < queue.numBanks(); ++bank_id) {
+        const auto& bank_pkts = queue.bankPackets(bank_id);
+        if (bank_pkts.empty())
+            continue;
 
-        // check if rank is not doing a refresh and thus is available, if not,
-        // jump to the next packet
-        if (dram_pkt->rankRef.inRefIdleState()) {
+        // check if rank is not doing a refresh and thus is available, if
+        // not, jump to the next bank
+        const Rank& rank = bank_pkts.front()->rankRef;
+        if (!rank.inRefIdleState()) {
+            DPRINTF(DRAM, "%s bank %d - Rank %d not available\n", __func__,
+                    bank_pkts.front()->bank, rank.rank);
+            continue;
+        }
 
-            DPRINTF(DRAM,
-                    "%s bank %d - Rank %d available\n", __func__,
-                    dram_pkt->bankRef.bank, dram_pkt->rankRef.rank);
-
-            // check if it is a row hit
-            if (bank.openRow == dram_pkt->row) {
-                // no additional rank-to-rank or same bank-group
-                // delays, or we switched read/write and might as well
-                // go for the row hit
-                if (col_allowed_at <= min_col_at) {
-                    // FCFS within the hits, giving priority to
-                    // commands that can issue seamlessly, without
-                    // additional delay, such as same rank accesses
-                    // and/or different bank-group accesses
-                    DPRINTF(DRAM, "%s Seamless row buffer hit\n", __func__);
-                    selected_pkt_it = i;
-                    // no need to look through the remaining queue entries
-                    break;
-                } else if (!found_hidden_bank && !found_prepped_pkt) {
-                    // if we did not find a packet to a closed row that can
-                    // issue the bank commands without incurring delay, and
-                    // did not yet find a packet to a prepped row, remember
-                    // the current one
-                    selected_pkt_it = i;
-                    found_prepped_pkt = true;
-                    DPRINTF(DRAM, "%s Prepped row buffer hit\n", __func__);
-                }
-            } else if (!found_earliest_pkt) {
-                // if we have not initialised the bank status, do it
-                // now, and only once per scheduling decisions
-                if (!filled_earliest_banks) {
-                    // determine entries with earliest bank delay
-                    std::tie(earliest_banks, hidden_bank_prep) =
-                        minBankPrep(queue, min_col_at);
-                    filled_earliest_banks = true;
-                }
+        const Bank& bank = bank_pkts.front()->bankRef;
+        for (auto dram_pkt : bank_pkts) {
+            if (bank.openRow != dram_pkt->row)
+                continue;
+
+            // no additional rank-to-rank or same bank-group delays, or
+            // we switched read/write and might as well go for the row hit
+            const Tick col_allowed_at = dram_pkt->isRead() ?
+                bank.rdAllowedAt : bank.wrAllowedAt;
+            DRAMPacket*& hit_pkt = col_allowed_at <= min_col_at ?
+                seamless_pkt : prepped_pkt;
+            if (!hit_pkt || dram_pkt->queueSeq < hit_pkt->queueSeq)
+                hit_pkt = dram_pkt;
+            break;
+        }
+    }
 
-                // bank is amongst first available banks
-                // minBankPrep will give priority to packets that can
-                // issue seamlessly
-                if (bits(earliest_banks[dram_pkt->rank],
-                         dram_pkt->bank, dram_pkt->bank)) {
-                    found_earliest_pkt = true;
-                    found_hidden_bank = hidden_bank_prep;
-
-                    // give priority to packets that can issue
-                    // bank commands 'behind the scenes'
-                    // any additional delay if any will be due to
-                    // col-to-col command requirements
-                    if (hidden_bank_prep || !found_prepped_pkt)
-                        selected_pkt_it = i;
-                }
-            }
-        } else {
-            DPRINTF(DRAM, "%s bank %d - Rank %d not available\n", __func__,
-                    dram_pkt->bankRef.bank, dram_pkt->rankRef.rank);
+    if (seamless_pkt) {
+        // FCFS within the hits, giving priority to commands that can
+        // issue seamlessly, without additional delay, such as same rank
+        // accesses and/or different bank-group accesses
+        DPRINTF(DRAM, "%s Seamless row buffer hit\n", __func__);
+        return seamless_pkt->queuePos;
+    }
+
+    // determine banks with earliest bank delay; minBankPrep will give
+    // priority to packets that can issue seamlessly
+    vector<uint32_t> earliest_banks;
+    bool hidden_bank_prep;
+    std::tie(earliest_banks, hidden_bank_prep) =
+        minBankPrep(queue, min_col_at);
+
+    // first packet to a closed row amongst the first available banks
+    DRAMPacket* earliest_pkt = nullptr;
+    for (uint16_t bank_id = 0; bank_id < queue.numBanks(); ++bank_id) {
+        const uint8_t rank = bank_id / banksPerRank;
+        const uint8_t bank = bank_id % banksPerRank;
+        if (!bits(earliest_banks[rank], bank, bank))
+            continue;
+
+        for (auto dram_pkt : queue.bankPackets(bank_id)) {
+            if (dram_pkt->bankRef.openRow == dram_pkt->row)
+                continue;
+            if (!earliest_pkt || dram_pkt->queueSeq < earliest_pkt->queueSeq)
+                earliest_pkt = dram_pkt;
+            break;
         }
     }
 
-    if (selected_pkt_it == queue.end()) {
-        DPRINTF(DRAM, "%s no available ranks found\n", __func__);
+    // give priority to packets that can issue bank commands 'behind the
+    // scenes', any additional delay if any will be due to col-to-col
+    // command requirements
+    if (earliest_pkt && (hidden_bank_prep || !prepped_pkt))
+        return earliest_pkt->queuePos;
+
+    if (prepped_pkt) {
+        DPRINTF(DRAM, "%s Prepped row buffer hit\n", __func__);
+        return prepped_pkt->queuePos;
     }
 
-    return selected_pkt_it;
+    DPRINTF(DRAM, "%s no available ranks found\n", __func__);
+    return queue.end();
 }
 
 void
@@ -1203,24 +1201,23 @@ DRAMCtrl::doDRAMAccess(DRAMPacket* dram_pkt)
                 dram_pkt->isRead() ? readQueue : writeQueue;
 
         for (uint8_t i = 0; i < numPriorities(); ++i) {
-            auto p = queue[i].begin();
-            // keep on looking until we find a hit or reach the end of the queue
+            // only packets to the same bank can be hits or conflicts, so
+            // keep on looking through them until we find a hit or reach
+            // the end of the list
             // 1) if a hit is found, then both open and close adaptive policies keep
             // the page open
             // 2) if no hit is found, got_bank_conflict is set to true if a bank
             // conflict request is waiting in the queue
             // 3) make sure we are not considering the packet that we are
             // currently dealing with
-            while (!got_more_hits && p != queue[i].end()) {
-                if (dram_pkt != (*p)) {
-                    bool same_rank_bank = (dram_pkt->rank == (*p)->rank) &&
-                                          (dram_pkt->bank == (*p)->bank);
-
-                    bool same_row = dram_pkt->row == (*p)->row;
-                    got_more_hits |= same_rank_bank && same_row;
-                    got_bank_conflict |= same_rank_bank && !same_row;
+            for (const auto& p : queue[i].bankPackets(dram_pkt->bankId)) {
+                if (dram_pkt != p) {
+                    bool same_row = dram_pkt->row == p->row;
+                    got_more_hits |= same_row;
+                    got_bank_conflict |= !same_row;
                 }
-                ++p;
+                if (got_more_hits)
+                    break;
             }
 
             if (got_more_hits)
@@ -1625,9 +1622,10 @@ DRAMCtrl::minBankPrep(const DRAMPacketQueue& queue,
     // determine if we have queued transactions targetting the
     // bank in question
     vector<bool> got_waiting(ranksPerChannel * banksPerRank, false);
-    for (const auto& p : queue) {
-        if (p->rankRef.inRefIdleState())
-            got_waiting[p->bankId] = true;
+    for (uint16_t bank_id = 0; bank_id < queue.numBanks(); ++bank_id) {
+        const auto& bank_pkts = queue.bankPackets(bank_id);
+        if (!bank_pkts.empty() && bank_pkts.front()->rankRef.inRefIdleState())
+            got_waiting[bank_id] = true;
     }
 
     // Find command with optimal bank timing
@@ -1692,9 +1690,10 @@ DRAMCtrl::minBankPrep(const DRAMPacketQueue& queue,
 DRAMCtrl::Rank::Rank(DRAMCtrl& _memory, const DRAMCtrlParams* _p, int rank)
     : EventManager(&_memory), memory(_memory),
       pwrStateTrans(PWR_IDLE), pwrStatePostRefresh(PWR_IDLE),
-      pwrStateTick(0), refreshDueAt(0), pwrState(PWR_IDLE),
-      refreshState(REF_IDLE), inLowPowerState(false), rank(rank),
-      readEntries(0), writeEntries(0), outstandingEvents(0),
+      pwrStateTick(0), refreshDueAt(0), refreshSkippedAt(0),
+      pwrState(PWR_IDLE), refreshState(REF_IDLE), inLowPowerState(false),
+      rank(rank), readEntries(0), writeEntries(0), outstandingEvents(0),
+      refreshSkipped(false),
       wakeUpAllowedAt(0), power(_p, false), banks(_p->banks_per_rank),
       numBanksActive(0), actTicks(_p->activation_limit, 0),
       writeDoneEvent([this]{ processWriteDoneEvent(); }, name()),
@@ -1741,10 +1740,14 @@ DRAMCtrl::Rank::startup(Tick ref_tick)
 void
 DRAMCtrl::Rank::suspend()
 {
+    // the controller catches up on the skipped refreshes of all the
+    // ranks before suspending them
+    assert(!refreshSkipped);
+
     deschedule(refreshEvent);
 
     // Update the stats
-    updatePowerStats();
+    updatePowerStats(curTick());
 
     // don't automatically transition back to LP state after next REF
     pwrStatePostRefresh = PWR_IDLE;
@@ -1775,8 +1778,101 @@ DRAMCtrl::Rank::checkDrainDone()
     }
 }
 
+bool
+DRAMCtrl::Rank::canSkipRefresh() const
+{
+    // with power-down enabled an idle rank ends up in self-refresh,
+    // which does not involve any events, so only the loop of
+    // auto-refreshes with the rank in the idle power state is skipped
+    if (!memory.skipIdleRefresh || memory.enableDRAMPowerdown)
+        return false;
+
+    // nothing queued, in flight, or about to change the bus state,
+    // so that the request event after each refresh finds nothing to do
+    if (memory.totalReadQueueSize || memory.totalWriteQueueSize ||
+        !memory.respQueue.empty() || memory.nextReqEvent.scheduled() ||
+        memory.respondEvent.scheduled() ||
+        memory.drainState() != DrainState::Running ||
+        memory.turnPolicy || memory.busState != READ ||
+        memory.busStateNext != READ)
+        return false;
+
+    return pwrState == PWR_IDLE && pwrStatePostRefresh == PWR_IDLE &&
+        !inLowPowerState && numBanksActive == 0 &&
+        outstandingEvents == 0 && readEntries == 0 && writeEntries == 0 &&
+        !activateEvent.scheduled() && !prechargeEvent.scheduled() &&
+        !powerEvent.scheduled() && !wakeUpEvent.scheduled() &&
+        !writeDoneEvent.scheduled();
+}
+
 void
-DRAMCtrl::Rank::flushCmdList()
+DRAMCtrl::Rank::catchUpRefresh()
+{
+    if (!refreshSkipped)
+        return;
+
+    refreshSkipped = false;
+
+    // replay the refreshes that were due, the same way the refresh
+    // and power state machines perform them on an idle rank: straight
+    // from the idle power state to refreshing, and back to idle tRFC
+    // later, with the controller looking for work in between
+    Tick ref_at = refreshSkippedAt;
+    unsigned int num_refreshes = 0;
+
+    while (ref_at < curTick()) {
+        stats.memoryStateTime[pwrState] += ref_at - pwrStateTick;
+        pwrState = PWR_REF;
+        pwrStateTrans = PWR_REF;
+        pwrStateTick = ref_at;
+        refreshDueAt = ref_at;
+
+        Tick ref_done_at = ref_at + memory.tRFC;
+
+        for (auto &b : banks) {
+            b.actAllowedAt = ref_done_at;
+        }
+
+        cmdList.push_back(Command(MemCommand::REF, 0, ref_at));
+
+        updatePowerStats(ref_at);
+
+        DPRINTF(DRAMPower, "%llu,REF,0,%d\n", divCeil(ref_at, memory.tCK) -
+                memory.timeStampOffset, rank);
+
+        refreshDueAt += memory.tREFI;
+        ++num_refreshes;
+
+        if (ref_done_at >= curTick()) {
+            // still refreshing, let the refresh event loop finish
+            ++outstandingEvents;
+            refreshState = REF_RUN;
+            schedule(refreshEvent, ref_done_at);
+
+            DPRINTF(DRAMState, "Rank %d caught up on %d refreshes, "
+                    "refreshing until %llu\n", rank, num_refreshes,
+                    ref_done_at);
+            return;
+        }
+
+        stats.memoryStateTime[PWR_REF] += memory.tRFC;
+        pwrState = PWR_IDLE;
+        pwrStateTrans = PWR_IDLE;
+        pwrStateTick = ref_done_at;
+
+        memory.refreshesDoneAt.insert(ref_done_at);
+
+        ref_at = refreshDueAt - memory.tRP;
+    }
+
+    schedule(refreshEvent, ref_at);
+
+    DPRINTF(DRAMState, "Rank %d caught up on %d refreshes, next refresh "
+            "at %llu\n", rank, num_refreshes, ref_at);
+}
+
+void
+DRAMCtrl::Rank::flushCmdList(Tick now)
 {
     // at the moment sort the list of commands and update the counters
     // for DRAMPower libray when doing a refresh
@@ -1786,19 +1882,19 @@ DRAMCtrl::Rank::flushCmdList()
     // push to commands to DRAMPower
     for ( ; next_iter != cmdList.end() ; ++next_iter) {
          Command cmd = *next_iter;
-         if (cmd.timeStamp <= curTick()) {
-             // Move all commands at or before curTick to DRAMPower
+         if (cmd.timeStamp <= now) {
+             // Move all commands at or before now to DRAMPower
              power.powerlib.doCommand(cmd.type, cmd.bank,
                                       divCeil(cmd.timeStamp, memory.tCK) -
                                       memory.timeStampOffset);
          } else {
-             // done - found all commands at or before curTick()
-             // next_iter references the 1st command after curTick
+             // done - found all commands at or before now
+             // next_iter references the 1st command after now
              break;
          }
     }
-    // reset cmdList to only contain commands after curTick
-    // if there are no commands after curTick, updated cmdList will be empty
+    // reset cmdList to only contain commands after now
+    // if there are no commands after now, updated cmdList will be empty
     // in this case, next_iter is cmdList.end()
     cmdList.assign(next_iter, cmdList.end());
 }
@@ -1858,6 +1954,17 @@ DRAMCtrl::Rank::processWriteDoneEvent()
 void
 DRAMCtrl::Rank::processRefreshEvent()
 {
+    // rather than going through the same refresh sequence every tREFI
+    // while nothing else happens, stop here and let catchUpRefresh
+    // account for the refreshes once the rank is needed again
+    if (refreshState == REF_IDLE && canSkipRefresh()) {
+        DPRINTF(DRAMState, "Rank %d idle, skipping refreshes from %llu\n",
+                rank, curTick());
+        refreshSkipped = true;
+        refreshSkippedAt = curTick();
+        return;
+    }
+
     // when first preparing the refresh, remember when it was due
     if ((refreshState == REF_IDLE) || (refreshState == REF_SREF_EXIT)) {
         // remember when the refresh is due
@@ -1983,7 +2090,7 @@ DRAMCtrl::Rank::processRefreshEvent()
         cmdList.push_back(Command(MemCommand::REF, 0, curTick()));
 
         // Update the stats
-        updatePowerStats();
+        updatePowerStats(curTick());
 
         DPRINTF(DRAMPower, "%llu,REF,0,%d\n", divCeil(curTick(), memory.tCK) -
                 memory.timeStampOffset, rank);
@@ -2333,17 +2440,17 @@ DRAMCtrl::Rank::processPowerEvent()
 }
 
 void
-DRAMCtrl::Rank::updatePowerStats()
+DRAMCtrl::Rank::updatePowerStats(Tick now)
 {
     // All commands up to refresh have completed
     // flush cmdList to DRAMPower
-    flushCmdList();
+    flushCmdList(now);
 
     // Call the function that calculates window energy at intermediate update
     // events like at refresh, stats dump as well as at simulation exit.
     // Window starts at the last time the calcWindowEnergy function was called
     // and is upto current time.
-    power.powerlib.calcWindowEnergy(divCeil(curTick(), memory.tCK) -
+    power.powerlib.calcWindowEnergy(divCeil(now, memory.tCK) -
                                     memory.timeStampOffset);
 
     // Get the energy from DRAMPower
@@ -2371,7 +2478,7 @@ DRAMCtrl::Rank::updatePowerStats()
     // power (mW) = ----------- * ----------
     //              time (tick)   tick_frequency
     stats.averagePower = (stats.totalEnergy.value() /
-                          (curTick() - memory.lastStatsResetTick)) *
+                          (now - memory.lastStatsResetTick)) *
                          (SimClock::Frequency / 1000000000.0);
 }
 
@@ -2381,7 +2488,7 @@ DRAMCtrl::Rank::computeStats()
     DPRINTF(DRAM,"Computing stats due to a dump callback\n");
 
     // Update the stats
-    updatePowerStats();
+    updatePowerStats(curTick());
 
     // final update of power state times
     stats.memoryStateTime[pwrState] += (curTick() - pwrStateTick);
@@ -2718,6 +2825,8 @@ DRAMCtrl::getPort(const string &if_name, PortID idx)
 DrainState
 DRAMCtrl::drain()
 {
+    catchUpRefreshes();
+
     // if there is anything in any of our internal queues, keep track
     // of that as well
     if (!(!totalWriteQueueSize && !totalReadQueueSize && respQueue.empty() &&
@@ -2749,6 +2858,40 @@ DRAMCtrl::drain()
     }
 }
 
+void
+DRAMCtrl::catchUpRefreshes()
+{
+    for (auto r : ranks) {
+        r->catchUpRefresh();
+    }
+
+    // after a refresh the first rank to finish schedules the request
+    // event and the others find it scheduled, so the request event
+    // only looks at the bus state once for the ranks that finished
+    // refreshing at the same tick
+    for (size_t i = 0; i < refreshesDoneAt.size(); i++) {
+        recordTurnaroundStats();
+    }
+    refreshesDoneAt.clear();
+}
+
+void
+DRAMCtrl::resetStats()
+{
+    // the skipped refreshes belong to the stats being reset
+    catchUpRefreshes();
+
+    QoS::MemCtrl::resetStats();
+}
+
+void
+DRAMCtrl::preDumpStats()
+{
+    catchUpRefreshes();
+
+    QoS::MemCtrl::preDumpStats();
+}
+
 bool
 DRAMCtrl::allRanksDrained() const
 {
@@ -2774,6 +2917,7 @@ DRAMCtrl::drainResume()
     } else if (isTimingMode && !system()->isTimingMode()) {
         // if we switch from timing mode, stop the refresh events to
         // not cause issues with KVM
+        catchUpRefreshes();
         for (auto r : ranks) {
             r->suspend();
         }
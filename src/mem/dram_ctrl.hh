@@ -55,6 +55,8 @@
 #define __MEM_DRAM_CTRL_HH__
 
 #include <deque>
+#include <list>
+#include <set>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -368,10 +370,27 @@ class DRAMCtrl : public QoS::MemCtrl
          */
         Tick refreshDueAt;
 
+        /**
+         * Tick at which the refresh event loop was stopped while the
+         * controller was idle, valid when refreshSkipped is set.
+         */
+        Tick refreshSkippedAt;
+
         /**
          * Function to update Power Stats
+         *
+         * @param now Tick up to which the stats are brought up to date
+         */
+        void updatePowerStats(Tick now);
+
+        /**
+         * Check if the rank and the controller are idle to the point
+         * where the only events left are the periodic refreshes, and
+         * the refresh event loop can be stopped.
+         *
+         * @return true if the refreshes can be skipped
          */
-        void updatePowerStats();
+        bool canSkipRefresh() const;
 
         /**
          * Schedule a power state transition in the future, and
@@ -421,6 +440,12 @@ class DRAMCtrl : public QoS::MemCtrl
          */
         uint8_t outstandingEvents;
 
+        /**
+         * True while the refresh event loop is stopped on an idle
+         * rank, see catchUpRefresh
+         */
+        bool refreshSkipped;
+
         /**
          * delay power-down and self-refresh exit until this requirement is met
          */
@@ -474,6 +499,13 @@ class DRAMCtrl : public QoS::MemCtrl
          */
         void suspend();
 
+        /**
+         * Account for the refreshes skipped while the rank was idle,
+         * updating the power state and DRAMPower exactly as the
+         * refresh event loop would have, and restart the loop.
+         */
+        void catchUpRefresh();
+
         /**
          * Check if there is no refresh and no preparation of refresh ongoing
          * i.e. the refresh state machine is in idle
@@ -522,11 +554,13 @@ class DRAMCtrl : public QoS::MemCtrl
 
         /**
          * Push command out of cmdList queue that are scheduled at
-         * or before curTick() to DRAMPower library
-         * All commands before curTick are guaranteed to be complete
+         * or before now to DRAMPower library
+         * All commands before now are guaranteed to be complete
          * and can safely be flushed.
+         *
+         * @param now Tick up to which commands are flushed
          */
-        void flushCmdList();
+        void flushCmdList(Tick now);
 
         /*
          * Function to register Stats
@@ -706,6 +740,17 @@ class DRAMCtrl : public QoS::MemCtrl
          */
         inline bool isWrite() const { return !read; }
 
+        /**
+         * Position of the packet in the read or write queue holding
+         * it, and in that queue's list of packets to its bank. Set
+         * when the packet is queued.
+         */
+        std::list<DRAMPacket*>::iterator queuePos;
+        std::list<DRAMPacket*>::iterator bankPos;
+
+        /** Arrival order of the packet in the queue holding it */
+        uint64_t queueSeq;
+
 
         DRAMPacket(PacketPtr _pkt, bool is_read, uint8_t _rank, uint8_t _bank,
                    uint32_t _row, uint16_t bank_id, Addr _addr,
@@ -719,9 +764,76 @@ class DRAMCtrl : public QoS::MemCtrl
 
     };
 
-    // The DRAM packets are store in a multiple dequeue structure,
-    // based on their QoS priority
-    typedef std::deque<DRAMPacket*> DRAMPacketQueue;
+    /**
+     * The DRAM packets of one QoS priority, in arrival order. The queue
+     * also keeps the packets to every bank in a list of their own, in
+     * the same order, so that the scheduler can look for row hits and
+     * bank conflicts bank by bank, rather than walking the whole queue
+     * on every decision.
+     */
+    class DRAMPacketQueue
+    {
+      public:
+        typedef std::list<DRAMPacket*> PacketList;
+        typedef PacketList::iterator iterator;
+        typedef PacketList::const_iterator const_iterator;
+
+        DRAMPacketQueue(unsigned num_banks)
+            : banks(num_banks), nextSeq(0)
+        { }
+
+        iterator begin() { return packets.begin(); }
+        iterator end() { return packets.end(); }
+        const_iterator begin() const { return packets.begin(); }
+        const_iterator end() const { return packets.end(); }
+
+        size_t size() const { return packets.size(); }
+        bool empty() const { return packets.empty(); }
+
+        /** Queue a packet behind all the others */
+        void
+        push_back(DRAMPacket* dram_pkt)
+        {
+            assert(dram_pkt->bankId < banks.size());
+            PacketList& bank = banks[dram_pkt->bankId];
+            dram_pkt->queuePos = packets.insert(packets.end(), dram_pkt);
+            dram_pkt->bankPos = bank.insert(bank.end(), dram_pkt);
+            dram_pkt->queueSeq = nextSeq++;
+        }
+
+        /**
+         * Remove a packet from the queue.
+         *
+         * @return An iterator to the packet that followed it
+         */
+        iterator
+        erase(iterator it)
+        {
+            DRAMPacket* dram_pkt = *it;
+            banks[dram_pkt->bankId].erase(dram_pkt->bankPos);
+            return packets.erase(it);
+        }
+
+        /** Number of banks, across all the ranks */
+        unsigned numBanks() const { return banks.size(); }
+
+        /** The queued packets to a bank, in arrival order */
+        const PacketList&
+        bankPackets(uint16_t bank_id) const
+        {
+            return banks[bank_id];
+        }
+
+      private:
+        /** All the queued packets, in arrival order */
+        PacketList packets;
+
+        /** The queued packets to each bank, indexed by bank id */
+        std::vector<PacketList> banks;
+
+        /** Arrival order of the next packet to be queued */
+        uint64_t nextSeq;
+    };
 
     /**
      * Bunch of things requires to setup "events" in gem5
@@ -1148,6 +1260,24 @@ class DRAMCtrl : public QoS::MemCtrl
     /** Enable or disable DRAM powerdown states. */
     bool enableDRAMPowerdown;
 
+    /**
+     * Stop the refresh events of idle ranks and account for the
+     * skipped refreshes when the controller is next used.
+     */
+    const bool skipIdleRefresh;
+
+    /**
+     * Bring the ranks with skipped refreshes up to date, to be done
+     * before anything looks at or changes their state.
+     */
+    void catchUpRefreshes();
+
+    /**
+     * The ticks at which the refreshes replayed by catchUpRefreshes
+     * finished, across all the ranks.
+     */
+    std::set<Tick> refreshesDoneAt;
+
     /**
      * Upstream caches need this packet until true is returned, so
      * hold it for deletion until a subsequent call
@@ -1181,6 +1311,9 @@ class DRAMCtrl : public QoS::MemCtrl
 
     DrainState drain() override;
 
+    void resetStats() override;
+    void preDumpStats() override;
+
     Port &getPort(const std::string &if_name,
                   PortID idx=InvalidPortID) override;
 
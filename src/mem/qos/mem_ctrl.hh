@@ -401,13 +401,14 @@ MemCtrl::escalateQueues(Queues& queues, uint64_t queue_entry_size,
                 writeQueueSizes[tgt_prio] += moved_entries;
             }
 
+            // Erase element from source packet queue, this will
+            // increment the iterator. Do it before queueing the packet
+            // again, as a queue may keep its own state in the packet
+            it = queues[curr_prio].erase(it);
+
             // Change QoS priority and move packet
             pkt->qosValue(tgt_prio);
             queues[tgt_prio].push_back(pkt);
-
-            // Erase element from source packet queue, this will
-            // increment the iterator
-            it = queues[curr_prio].erase(it);
             panic_if(packetPriorities[m_id][curr_prio] < moved_entries,
                      "QoSMemCtrl::escalate master %s negative packets "
                      "for priority %d",
@@ -39,17 +39,38 @@ Consumer::scheduleEvent(Cycles timeDelta)
 void
 Consumer::scheduleEventAbsolute(Tick evt_time)
 {
+    std::unique_lock<std::mutex> lock(m_wakeup_mutex, std::defer_lock);
+    if (inParallelMode)
+        lock.lock();
+
     if (!alreadyScheduled(evt_time)) {
         // This wakeup is not redundant
         auto *evt = new EventFunctionWrapper(
-            [this]{ wakeup(); }, "Consumer Event", true);
+            [this, evt_time]{ processWakeup(evt_time); },
+            "Consumer Event", true);
 
         em->schedule(evt, evt_time);
         insertScheduledWakeupTime(evt_time);
     }
+}
+
+void
+Consumer::processWakeup(Tick time)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_wakeup_mutex, std::defer_lock);
+        if (inParallelMode)
+            lock.lock();
+
+        for (int i = 0; i < m_pending_wakeups.size(); i++) {
+            if (m_pending_wakeups[i] == time) {
+                m_pending_wakeups[i] = m_pending_wakeups.back();
+                m_pending_wakeups.pop_back();
+                break;
+            }
+        }
+        m_last_wakeup = time;
+    }
 
-    Tick t = em->clockEdge();
-    set<Tick>::iterator bit = m_scheduled_wakeups.begin();
-    set<Tick>::iterator eit = m_scheduled_wakeups.lower_bound(t);
-    m_scheduled_wakeups.erase(bit,eit);
+    wakeup();
 }
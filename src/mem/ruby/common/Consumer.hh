@@ -36,7 +36,8 @@
 #define __MEM_RUBY_COMMON_CONSUMER_HH__
 
 #include <iostream>
-#include <set>
+#include <mutex>
+#include <vector>
 
 #include "sim/clocked_object.hh"
 
@@ -44,7 +45,7 @@ class Consumer
 {
   public:
     Consumer(ClockedObject *_em)
-        : em(_em)
+        : m_last_wakeup(MaxTick), em(_em)
     {
     }
 
@@ -56,16 +57,24 @@ class Consumer
     virtual void print(std::ostream& out) const = 0;
     virtual void storeEventInfo(int info) {}
 
+    // A consumer is woken up at most once per tick: a wakeup is redundant
+    // if one is pending for that tick or is the one being processed.
     bool
     alreadyScheduled(Tick time)
     {
-        return m_scheduled_wakeups.find(time) != m_scheduled_wakeups.end();
+        if (time == m_last_wakeup)
+            return true;
+        for (auto pending : m_pending_wakeups) {
+            if (pending == time)
+                return true;
+        }
+        return false;
     }
 
     void
     insertScheduledWakeupTime(Tick time)
     {
-        m_scheduled_wakeups.insert(time);
+        m_pending_wakeups.push_back(time);
     }
 
     void scheduleEventAbsolute(Tick timeAbs);
@@ -74,8 +83,18 @@ class Consumer
     void scheduleEvent(Cycles timeDelta);
 
   private:
-    std::set<Tick> m_scheduled_wakeups;
+    void processWakeup(Tick time);
+
+    // Tick of the latest wakeup and the ticks of the wakeups still
+    // pending. A consumer rarely has more than a couple of wakeups in
+    // flight, so a short unordered list beats a search tree here.
+    Tick m_last_wakeup;
+    std::vector<Tick> m_pending_wakeups;
     ClockedObject *em;
+
+    // In parallel mode a consumer may be woken up from the thread of
+    // another event queue (e.g., by a garnet link)
+    std::mutex m_wakeup_mutex;
 };
 
 inline std::ostream&
@@ -30,24 +30,27 @@
 
 #include <algorithm>
 
+#include "base/bitfield.hh"
+
 NetDest::NetDest()
 {
-  resize();
+    clear();
 }
 
 void
 NetDest::add(MachineID newElement)
 {
-    assert(bitIndex(newElement.num) < m_bits[vecIndex(newElement)].getSize());
-    m_bits[vecIndex(newElement)].add(bitIndex(newElement.num));
+    assert(bitIndex(newElement.num) < MachineType_base_count(newElement.type));
+    int vec_index = vecIndex(newElement);
+    NodeID index = bitIndex(newElement.num);
+    m_bits[wordIndex(vec_index, index)] |= bitMask(index);
 }
 
 void
 NetDest::addNetDest(const NetDest& netDest)
 {
-    assert(m_bits.size() == netDest.getSize());
-    for (int i = 0; i < m_bits.size(); i++) {
-        m_bits[i].addSet(netDest.m_bits[i]);
+    for (int i = 0; i < numWords; i++) {
+        m_bits[i] |= netDest.m_bits[i];
     }
 }
 
@@ -57,30 +60,36 @@ NetDest::setNetDest(MachineType machine, const Set& set)
     // assure that there is only one set of destinations for this machine
     assert(MachineType_base_level((MachineType)(machine + 1)) -
            MachineType_base_level(machine) == 1);
-    m_bits[MachineType_base_level(machine)] = set;
+    int vec_index = MachineType_base_level(machine);
+    assert(set.getSize() <= MachineType_base_count(machine));
+    std::fill_n(&m_bits[wordIndex(vec_index, 0)], wordsPerRow, 0);
+    for (NodeID j = 0; j < set.getSize(); j++) {
+        if (set.isElement(j)) {
+            m_bits[wordIndex(vec_index, j)] |= bitMask(j);
+        }
+    }
 }
 
 void
 NetDest::remove(MachineID oldElement)
 {
-    m_bits[vecIndex(oldElement)].remove(bitIndex(oldElement.num));
+    int vec_index = vecIndex(oldElement);
+    NodeID index = bitIndex(oldElement.num);
+    m_bits[wordIndex(vec_index, index)] &= ~bitMask(index);
 }
 
 void
 NetDest::removeNetDest(const NetDest& netDest)
 {
-    assert(m_bits.size() == netDest.getSize());
-    for (int i = 0; i < m_bits.size(); i++) {
-        m_bits[i].removeSet(netDest.m_bits[i]);
+    for (int i = 0; i < numWords; i++) {
+        m_bits[i] &= ~netDest.m_bits[i];
     }
 }
 
 void
 NetDest::clear()
 {
-    for (int i = 0; i < m_bits.size(); i++) {
-        m_bits[i].clear();
-    }
+    std::fill_n(m_bits, numWords, 0);
 }
 
 void
@@ -106,13 +115,13 @@ std::vector<NodeID>
 NetDest::getAllDest()
 {
     std::vector<NodeID> dest;
-    dest.clear();
-    for (int i = 0; i < m_bits.size(); i++) {
-        for (int j = 0; j < m_bits[i].getSize(); j++) {
-            if (m_bits[i].isElement(j)) {
-                int id = MachineType_base_number((MachineType)i) + j;
-                dest.push_back((NodeID)id);
-            }
+    for (int i = 0; i < numWords; i++) {
+        int vec_index = i / wordsPerRow;
+        NodeID first = (i % wordsPerRow) * bitsPerWord;
+        for (Word word = m_bits[i]; word != 0; word &= word - 1) {
+            int id = MachineType_base_number((MachineType)vec_index) +
+                     first + findLsbSet(word);
+            dest.push_back((NodeID)id);
         }
     }
     return dest;
@@ -122,8 +131,18 @@ int
 NetDest::count() const
 {
     int counter = 0;
-    for (int i = 0; i < m_bits.size(); i++) {
-        counter += m_bits[i].count();
+    for (int i = 0; i < numWords; i++) {
+        counter += popCount(m_bits[i]);
+    }
+    return counter;
+}
+
+int
+NetDest::rowCount(int vec_index) const
+{
+    int counter = 0;
+    for (int i = 0; i < wordsPerRow; i++) {
+        counter += popCount(m_bits[vec_index * wordsPerRow + i]);
     }
     return counter;
 }
@@ -131,19 +150,20 @@ NetDest::count() const
 NodeID
 NetDest::elementAt(MachineID index)
 {
-    return m_bits[vecIndex(index)].elementAt(bitIndex(index.num));
+    return isElement(index);
 }
 
 MachineID
 NetDest::smallestElement() const
 {
     assert(count() > 0);
-    for (int i = 0; i < m_bits.size(); i++) {
-        for (NodeID j = 0; j < m_bits[i].getSize(); j++) {
-            if (m_bits[i].isElement(j)) {
-                MachineID mach = {MachineType_from_base_level(i), j};
-                return mach;
-            }
+    for (int i = 0; i < numWords; i++) {
+        if (m_bits[i] != 0) {
+            NodeID j = (i % wordsPerRow) * bitsPerWord +
+                       findLsbSet(m_bits[i]);
+            MachineID mach = {MachineType_from_base_level(i / wordsPerRow),
+                              j};
+            return mach;
         }
     }
     panic("No smallest element of an empty set.");
@@ -152,10 +172,12 @@ NetDest::smallestElement() const
 MachineID
 NetDest::smallestElement(MachineType machine) const
 {
-    int size = m_bits[MachineType_base_level(machine)].getSize();
-    for (NodeID j = 0; j < size; j++) {
-        if (m_bits[MachineType_base_level(machine)].isElement(j)) {
-            MachineID mach = {machine, j};
+    int vec_index = MachineType_base_level(machine);
+    for (int i = 0; i < wordsPerRow; i++) {
+        Word word = m_bits[vec_index * wordsPerRow + i];
+        if (word != 0) {
+            MachineID mach = {machine, (NodeID)(i * bitsPerWord +
+                                                findLsbSet(word))};
             return mach;
         }
     }
@@ -167,8 +189,8 @@ NetDest::smallestElement(MachineType machine) const
 bool
 NetDest::isBroadcast() const
 {
-    for (int i = 0; i < m_bits.size(); i++) {
-        if (!m_bits[i].isBroadcast()) {
+    for (int i = 0; i < MachineType_NUM; i++) {
+        if (rowCount(i) != MachineType_base_count((MachineType)i)) {
             return false;
         }
     }
@@ -179,22 +201,20 @@ NetDest::isBroadcast() const
 bool
 NetDest::isEmpty() const
 {
-    for (int i = 0; i < m_bits.size(); i++) {
-        if (!m_bits[i].isEmpty()) {
-            return false;
-        }
+    Word any = 0;
+    for (int i = 0; i < numWords; i++) {
+        any |= m_bits[i];
     }
-    return true;
+    return any == 0;
 }
 
 // returns the logical OR of "this" set and orNetDest
 NetDest
 NetDest::OR(const NetDest& orNetDest) const
 {
-    assert(m_bits.size() == orNetDest.getSize());
     NetDest result;
-    for (int i = 0; i < m_bits.size(); i++) {
-        result.m_bits[i] = m_bits[i].OR(orNetDest.m_bits[i]);
+    for (int i = 0; i < numWords; i++) {
+        result.m_bits[i] = m_bits[i] | orNetDest.m_bits[i];
     }
     return result;
 }
@@ -203,10 +223,9 @@ NetDest::OR(const NetDest& orNetDest) const
 NetDest
 NetDest::AND(const NetDest& andNetDest) const
 {
-    assert(m_bits.size() == andNetDest.getSize());
     NetDest result;
-    for (int i = 0; i < m_bits.size(); i++) {
-        result.m_bits[i] = m_bits[i].AND(andNetDest.m_bits[i]);
+    for (int i = 0; i < numWords; i++) {
+        result.m_bits[i] = m_bits[i] & andNetDest.m_bits[i];
     }
     return result;
 }
@@ -215,53 +234,41 @@ NetDest::AND(const NetDest& andNetDest) const
 bool
 NetDest::intersectionIsNotEmpty(const NetDest& other_netDest) const
 {
-    assert(m_bits.size() == other_netDest.getSize());
-    for (int i = 0; i < m_bits.size(); i++) {
-        if (!m_bits[i].intersectionIsEmpty(other_netDest.m_bits[i])) {
-            return true;
-        }
+    Word common = 0;
+    for (int i = 0; i < numWords; i++) {
+        common |= m_bits[i] & other_netDest.m_bits[i];
     }
-    return false;
+    return common != 0;
 }
 
 bool
 NetDest::isSuperset(const NetDest& test) const
 {
-    assert(m_bits.size() == test.getSize());
-
-    for (int i = 0; i < m_bits.size(); i++) {
-        if (!m_bits[i].isSuperset(test.m_bits[i])) {
-            return false;
-        }
+    Word missing = 0;
+    for (int i = 0; i < numWords; i++) {
+        missing |= test.m_bits[i] & ~m_bits[i];
     }
-    return true;
+    return missing == 0;
 }
 
 bool
 NetDest::isElement(MachineID element) const
 {
-    return ((m_bits[vecIndex(element)])).isElement(bitIndex(element.num));
-}
-
-void
-NetDest::resize()
-{
-    m_bits.resize(MachineType_base_level(MachineType_NUM));
-    assert(m_bits.size() == MachineType_NUM);
-
-    for (int i = 0; i < m_bits.size(); i++) {
-        m_bits[i].setSize(MachineType_base_count((MachineType)i));
-    }
+    int vec_index = vecIndex(element);
+    NodeID index = bitIndex(element.num);
+    return (m_bits[wordIndex(vec_index, index)] & bitMask(index)) != 0;
 }
 
 void
 NetDest::print(std::ostream& out) const
 {
-    out << "[NetDest (" << m_bits.size() << ") ";
+    out << "[NetDest (" << getSize() << ") ";
 
-    for (int i = 0; i < m_bits.size(); i++) {
-        for (int j = 0; j < m_bits[i].getSize(); j++) {
-            out << (bool) m_bits[i].isElement(j) << " ";
+    for (int i = 0; i < MachineType_NUM; i++) {
+        MachineType machine = MachineType_from_base_level(i);
+        for (NodeID j = 0; j < MachineType_base_count(machine); j++) {
+            MachineID mach = {machine, j};
+            out << isElement(mach) << " ";
         }
         out << " - ";
     }
@@ -271,10 +278,9 @@ NetDest::print(std::ostream& out) const
 bool
 NetDest::isEqual(const NetDest& n) const
 {
-    assert(m_bits.size() == n.m_bits.size());
-    for (unsigned int i = 0; i < m_bits.size(); ++i) {
-        if (!m_bits[i].isEqual(n.m_bits[i]))
-            return false;
+    Word diff = 0;
+    for (int i = 0; i < numWords; i++) {
+        diff |= m_bits[i] ^ n.m_bits[i];
     }
-    return true;
+    return diff == 0;
 }
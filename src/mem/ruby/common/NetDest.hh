@@ -29,13 +29,20 @@
 #ifndef __MEM_RUBY_COMMON_NETDEST_HH__
 #define __MEM_RUBY_COMMON_NETDEST_HH__
 
+#include <cstdint>
 #include <iostream>
 #include <vector>
 
-#include "mem/ruby/common/Set.hh"
 #include "mem/ruby/common/MachineID.hh"
+#include "mem/ruby/common/Set.hh"
 
-// NetDest specifies the network destination of a Message
+// NetDest specifies the network destination of a Message.
+//
+// It is a bit matrix with a row of NUMBER_BITS_PER_SET bits per machine
+// type. The rows are laid out back to back in one inline array of words,
+// so a NetDest is copied without any allocation and the set operations
+// are loops over a fixed number of words, which the compiler unrolls and
+// vectorizes. Bits past the machine count of a row are always clear.
 class NetDest
 {
   public:
@@ -84,8 +91,7 @@ class NetDest
     MachineID smallestElement() const;
     MachineID smallestElement(MachineType machine) const;
 
-    void resize();
-    int getSize() const { return m_bits.size(); }
+    int getSize() const { return MachineType_NUM; }
 
     // get element for a index
     NodeID elementAt(MachineID index);
@@ -93,19 +99,41 @@ class NetDest
     void print(std::ostream& out) const;
 
   private:
+    typedef uint64_t Word;
+    static const int bitsPerWord = 64;
+    static const int wordsPerRow =
+        (NUMBER_BITS_PER_SET + bitsPerWord - 1) / bitsPerWord;
+    static const int numWords = MachineType_NUM * wordsPerRow;
+
     // returns a value >= MachineType_base_level("this machine")
     // and < MachineType_base_level("next highest machine")
     int
     vecIndex(MachineID m) const
     {
         int vec_index = MachineType_base_level(m.type);
-        assert(vec_index < m_bits.size());
+        assert(vec_index < MachineType_NUM);
         return vec_index;
     }
 
     NodeID bitIndex(NodeID index) const { return index; }
 
-    std::vector<Set> m_bits;  // a vector of bit vectors - i.e. Sets
+    // The word of row vec_index that holds bit index, and its mask
+    int
+    wordIndex(int vec_index, NodeID index) const
+    {
+        assert(index < NUMBER_BITS_PER_SET);
+        return vec_index * wordsPerRow + index / bitsPerWord;
+    }
+
+    static Word
+    bitMask(NodeID index)
+    {
+        return Word(1) << (index % bitsPerWord);
+    }
+
+    int rowCount(int vec_index) const;
+
+    Word m_bits[numWords];
 };
 
 inline std::ostream&
@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mem/ruby/common/NetDest.hh"
+
+/*
+ * NetDest is only linked with the functions SLICC generates for the
+ * MachineType of the protocol, which get the number of controllers of
+ * each machine type from the controllers themselves. They are defined
+ * here instead, with made up numbers of controllers: some machine types
+ * fill their whole row of bits, and some have none.
+ */
+
+static const int controllers[] = {
+    NUMBER_BITS_PER_SET, 3, 0, NUMBER_BITS_PER_SET - 1, 1
+};
+
+int
+MachineType_base_count(const MachineType& obj)
+{
+    assert(obj < MachineType_NUM);
+    return controllers[obj % 5];
+}
+
+int
+MachineType_base_level(const MachineType& obj)
+{
+    assert(obj <= MachineType_NUM);
+    return obj;
+}
+
+MachineType
+MachineType_from_base_level(int level)
+{
+    assert(level < MachineType_NUM);
+    return (MachineType)level;
+}
+
+int
+MachineType_base_number(const MachineType& obj)
+{
+    assert(obj <= MachineType_NUM);
+    int base = 0;
+    for (int i = 0; i < obj; i++)
+        base += MachineType_base_count((MachineType)i);
+    return base;
+}
+
+std::string
+MachineType_to_string(const MachineType& obj)
+{
+    return "Machine" + std::to_string((int)obj);
+}
+
+MachineType &
+operator++(MachineType &e)
+{
+    assert(e < MachineType_NUM);
+    return e = MachineType(e + 1);
+}
+
+std::ostream &
+operator<<(std::ostream &out, const MachineType &obj)
+{
+    return out << MachineType_to_string(obj);
+}
+
+namespace {
+
+/** The reference: the set of (machine type, controller) pairs */
+typedef std::set<std::pair<int, NodeID>> Reference;
+
+std::vector<MachineID>
+allMachines()
+{
+    std::vector<MachineID> machines;
+    for (MachineType t = MachineType_FIRST; t < MachineType_NUM; ++t) {
+        for (NodeID i = 0; i < MachineType_base_count(t); i++) {
+            MachineID mach = {t, i};
+            machines.push_back(mach);
+        }
+    }
+    return machines;
+}
+
+/** A random destination, and the same destination as a reference */
+NetDest
+randomNetDest(std::mt19937 &rng, Reference &ref)
+{
+    const std::vector<MachineID> machines = allMachines();
+    NetDest dest;
+    ref.clear();
+    // sparse and dense destinations
+    const unsigned percent = rng() % 2 ? 5 : 60;
+    for (const auto &mach : machines) {
+        if (rng() % 100 < percent) {
+            dest.add(mach);
+            ref.emplace(mach.type, mach.num);
+        }
+    }
+    return dest;
+}
+
+void
+expectMatches(const NetDest &dest, const Reference &ref)
+{
+    ASSERT_EQ(dest.count(), ref.size());
+    ASSERT_EQ(dest.isEmpty(), ref.empty());
+    for (const auto &mach : allMachines()) {
+        ASSERT_EQ(dest.isElement(mach),
+                  ref.count(std::make_pair((int)mach.type, mach.num)) == 1);
+    }
+}
+
+} // anonymous namespace
+
+/** Testing adding and removing single controllers */
+TEST(NetDestTest, AddRemove)
+{
+    std::mt19937 rng(1);
+    const std::vector<MachineID> machines = allMachines();
+    NetDest dest;
+    Reference ref;
+    expectMatches(dest, ref);
+
+    for (int i = 0; i < 10000; i++) {
+        const MachineID &mach = machines[rng() % machines.size()];
+        if (rng() % 2) {
+            dest.add(mach);
+            ref.emplace(mach.type, mach.num);
+        } else {
+            dest.remove(mach);
+            ref.erase(std::make_pair((int)mach.type, mach.num));
+        }
+    }
+    expectMatches(dest, ref);
+
+    dest.clear();
+    ref.clear();
+    expectMatches(dest, ref);
+}
+
+/** Testing the operations on two destinations against the reference */
+TEST(NetDestTest, SetOperations)
+{
+    std::mt19937 rng(2);
+    for (int i = 0; i < 200; i++) {
+        Reference ref_a, ref_b;
+        const NetDest a = randomNetDest(rng, ref_a);
+        const NetDest b = randomNetDest(rng, ref_b);
+
+        Reference ref_or(ref_a), ref_and, ref_minus;
+        ref_or.insert(ref_b.begin(), ref_b.end());
+        for (const auto &m : ref_a)
+            (ref_b.count(m) ? ref_and : ref_minus).insert(m);
+
+        expectMatches(a.OR(b), ref_or);
+        expectMatches(a.AND(b), ref_and);
+
+        NetDest sum(a);
+        sum.addNetDest(b);
+        expectMatches(sum, ref_or);
+
+        NetDest difference(a);
+        difference.removeNetDest(b);
+        expectMatches(difference, ref_minus);
+
+        ASSERT_EQ(a.intersectionIsNotEmpty(b), !ref_and.empty());
+        ASSERT_EQ(a.isSuperset(b), ref_and.size() == ref_b.size());
+        ASSERT_EQ(b.isSubset(a), ref_and.size() == ref_b.size());
+        ASSERT_TRUE(sum.isSuperset(a));
+        ASSERT_TRUE(a.isSubset(sum));
+        ASSERT_EQ(a.isEqual(b), ref_a == ref_b);
+        ASSERT_TRUE(a.isEqual(NetDest(a)));
+    }
+}
+
+/** Testing broadcasts, which only cover the existing controllers */
+TEST(NetDestTest, Broadcast)
+{
+    const std::vector<MachineID> machines = allMachines();
+    Reference all;
+    for (const auto &mach : machines)
+        all.emplace(mach.type, mach.num);
+
+    NetDest dest;
+    dest.broadcast();
+    expectMatches(dest, all);
+    ASSERT_TRUE(dest.isBroadcast());
+
+    dest.remove(machines.back());
+    ASSERT_FALSE(dest.isBroadcast());
+
+    for (MachineType t = MachineType_FIRST; t < MachineType_NUM; ++t) {
+        NetDest row;
+        row.broadcast(t);
+        ASSERT_EQ(row.count(), MachineType_base_count(t));
+        ASSERT_TRUE(dest.OR(row).isSuperset(row));
+    }
+}
+
+/** Testing the searches for set controllers against the reference */
+TEST(NetDestTest, Elements)
+{
+    std::mt19937 rng(3);
+    for (int i = 0; i < 200; i++) {
+        Reference ref;
+        NetDest dest = randomNetDest(rng, ref);
+
+        std::vector<NodeID> expected;
+        for (const auto &m : ref) {
+            expected.push_back(
+                MachineType_base_number((MachineType)m.first) + m.second);
+        }
+        ASSERT_EQ(dest.getAllDest(), expected);
+
+        if (ref.empty())
+            continue;
+        const MachineID smallest = dest.smallestElement();
+        ASSERT_EQ(smallest.type, ref.begin()->first);
+        ASSERT_EQ(smallest.num, ref.begin()->second);
+
+        const MachineType t = smallest.type;
+        NodeID first_of_type = dest.smallestElement(t).num;
+        ASSERT_EQ(first_of_type, ref.lower_bound(
+            std::make_pair((int)t, NodeID(0)))->second);
+    }
+}
+
+/** Testing setting the controllers of a machine type from a Set */
+TEST(NetDestTest, SetNetDest)
+{
+    for (MachineType t = MachineType_FIRST; t < MachineType_NUM; ++t) {
+        const int count = MachineType_base_count(t);
+        Set set(count);
+        for (NodeID i = 0; i < count; i += 2)
+            set.add(i);
+
+        NetDest dest;
+        dest.broadcast();
+        dest.setNetDest(t, set);
+        for (NodeID i = 0; i < count; i++) {
+            MachineID mach = {t, i};
+            ASSERT_EQ(dest.isElement(mach), i % 2 == 0);
+        }
+        ASSERT_EQ(dest.count(), allMachines().size() - count / 2);
+    }
+}
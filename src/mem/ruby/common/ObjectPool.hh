@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __MEM_RUBY_COMMON_OBJECTPOOL_HH__
+#define __MEM_RUBY_COMMON_OBJECTPOOL_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// Free-list allocator for short-lived objects: the messages of every
+// protocol and the flits, credits and route info garnet creates on every
+// hop.
+// A class T deriving from PooledObject<T> gets class-specific
+// operator new/delete: freed objects are kept on a free list and handed
+// out again, and the free list is refilled a chunk of objects at a time,
+// so steady-state traffic never reaches the general-purpose heap.
+// Memory is only returned to the system at exit.
+//
+// Objects of a class derived from T (e.g., Credit from flit) fall back to
+// the global heap unless the derived class is pooled itself.
+//
+// With routers on several event queues (--network-threads) an object
+// may be freed by a different thread than the one that allocated it,
+// so every thread keeps its own free list and counters; a freed object
+// simply joins the free list of the thread that frees it.
+//
+// The pools belong to the process rather than to a network: the
+// class-specific operator new/delete have no way to tell which network
+// an object is for, and a process only simulates one Ruby system (see
+// the static state of RubySystem). The pool stats a GarnetNetwork
+// reports are thus the process-wide counters.
+
+template <class T>
+class PooledObject
+{
+  public:
+    struct PoolStats
+    {
+        uint64_t allocations;   // objects handed out
+        uint64_t capacity;      // objects carved from the heap so far
+        uint64_t live;          // objects currently handed out
+    };
+
+    static void *
+    operator new(size_t size)
+    {
+        if (size != sizeof(T))
+            return ::operator new(size);
+
+        if (freeList == nullptr)
+            refill();
+
+        FreeNode *node = freeList;
+        freeList = node->next;
+
+        PoolStats &stats = threadStats();
+        stats.allocations++;
+        stats.live++;
+        return node;
+    }
+
+    static void
+    operator delete(void *ptr, size_t size)
+    {
+        if (ptr == nullptr)
+            return;
+
+        if (size != sizeof(T)) {
+            ::operator delete(ptr);
+            return;
+        }
+
+        FreeNode *node = static_cast<FreeNode *>(ptr);
+        node->next = freeList;
+        freeList = node;
+        threadStats().live--;
+    }
+
+    // Summed over all threads
+    static PoolStats
+    getPoolStats()
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        PoolStats total = {0, 0, 0};
+        for (auto stats : allStats) {
+            total.allocations += stats->allocations;
+            total.capacity += stats->capacity;
+            total.live += stats->live;
+        }
+        return total;
+    }
+
+    static void
+    resetPoolStats()
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        for (auto stats : allStats)
+            stats->allocations = 0;
+    }
+
+  private:
+    struct FreeNode
+    {
+        FreeNode *next;
+    };
+
+    // Number of objects carved from the heap at a time
+    static const int chunkSize = 256;
+
+    static void
+    refill()
+    {
+        static_assert(sizeof(T) >= sizeof(FreeNode),
+                      "pooled object too small to hold a free-list link");
+
+        char *chunk = static_cast<char *>(::operator new(chunkSize *
+                                                         sizeof(T)));
+        for (int i = chunkSize - 1; i >= 0; i--) {
+            FreeNode *node = reinterpret_cast<FreeNode *>(chunk +
+                                                          i * sizeof(T));
+            node->next = freeList;
+            freeList = node;
+        }
+        threadStats().capacity += chunkSize;
+    }
+
+    // Counters of the calling thread, registered on first use.
+    // They outlive the thread, as do the objects it carved out.
+    static PoolStats &
+    threadStats()
+    {
+        static thread_local PoolStats *stats = nullptr;
+        if (stats == nullptr) {
+            stats = new PoolStats{0, 0, 0};
+            std::lock_guard<std::mutex> lock(statsMutex);
+            allStats.push_back(stats);
+        }
+        return *stats;
+    }
+
+    static thread_local FreeNode *freeList;
+    static std::mutex statsMutex;
+    static std::vector<PoolStats *> allStats;
+};
+
+template <class T>
+thread_local typename PooledObject<T>::FreeNode *PooledObject<T>::freeList =
+    nullptr;
+
+template <class T>
+std::mutex PooledObject<T>::statsMutex;
+
+template <class T>
+std::vector<typename PooledObject<T>::PoolStats *>
+    PooledObject<T>::allStats;
+
+#endif // __MEM_RUBY_COMMON_OBJECTPOOL_HH__
@@ -70,7 +70,7 @@ MessageBuffer::getSize(Tick curTime)
 {
     if (m_time_last_time_size_checked != curTime) {
         m_time_last_time_size_checked = curTime;
-        m_size_last_time_size_checked = m_prio_heap.size();
+        m_size_last_time_size_checked = queueSize();
     }
 
     return m_size_last_time_size_checked;
@@ -94,7 +94,7 @@ MessageBuffer::areNSlotsAvailable(unsigned int n, Tick current_time)
 
     if (m_time_last_time_pop < current_time) {
         // no pops this cycle - heap and stall queue size is correct
-        current_size = m_prio_heap.size();
+        current_size = queueSize();
         current_stall_size = m_stall_map_size;
     } else {
         if (m_time_last_time_enqueue < current_time) {
@@ -117,7 +117,7 @@ MessageBuffer::areNSlotsAvailable(unsigned int n, Tick current_time)
         DPRINTF(RubyQueue, "n: %d, current_size: %d, heap size: %d, "
                 "m_max_size: %d\n",
                 n, current_size + current_stall_size,
-                m_prio_heap.size(), m_max_size);
+                queueSize(), m_max_size);
         m_not_avail_count++;
         return false;
     }
@@ -127,7 +127,7 @@ const Message*
 MessageBuffer::peek() const
 {
     DPRINTF(RubyQueue, "Peeking at head of queue.\n");
-    const Message* msg_ptr = m_prio_heap.front().get();
+    const Message* msg_ptr = headMsgPtr().get();
     assert(msg_ptr);
 
     DPRINTF(RubyQueue, "Message: %s\n", (*msg_ptr));
@@ -207,15 +207,13 @@ MessageBuffer::enqueue(MsgPtr message, Tick current_time, Tick delta)
     msg_ptr->setLastEnqueueTime(arrival_time);
     msg_ptr->setMsgCounter(m_msg_counter);
 
-    // Insert the message into the priority heap
-    m_prio_heap.push_back(message);
-    push_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
+    DPRINTF(RubyQueue, "Enqueue arrival_time: %lld, Message: %s\n",
+            arrival_time, *msg_ptr);
+
+    insertMessage(std::move(message));
     // Increment the number of messages statistic
     m_buf_msgs++;
 
-    DPRINTF(RubyQueue, "Enqueue arrival_time: %lld, Message: %s\n",
-            arrival_time, *(message.get()));
-
     // Schedule the wakeup
     assert(m_consumer != NULL);
     m_consumer->scheduleEventAbsolute(arrival_time);
@@ -228,8 +226,8 @@ MessageBuffer::dequeue(Tick current_time, bool decrement_messages)
     DPRINTF(RubyQueue, "Popping\n");
     assert(isReady(current_time));
 
-    // get MsgPtr of the message about to be dequeued
-    MsgPtr message = m_prio_heap.front();
+    // get the message about to be dequeued
+    Message *message = headMsgPtr().get();
 
     // get the delay cycles
     message->updateDelayedTicks(current_time);
@@ -240,13 +238,12 @@ MessageBuffer::dequeue(Tick current_time, bool decrement_messages)
     // record previous size and time so the current buffer size isn't
     // adjusted until schd cycle
     if (m_time_last_time_pop < current_time) {
-        m_size_at_cycle_start = m_prio_heap.size();
+        m_size_at_cycle_start = queueSize();
         m_stalled_at_cycle_start = m_stall_map_size;
         m_time_last_time_pop = current_time;
     }
 
-    pop_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
-    m_prio_heap.pop_back();
+    popHead();
     if (decrement_messages) {
         // If the message will be removed from the queue, decrement the
         // number of message in the queue.
@@ -261,6 +258,35 @@ MessageBuffer::dequeue(Tick current_time, bool decrement_messages)
     return delay;
 }
 
+void
+MessageBuffer::insertMessage(MsgPtr message)
+{
+    // In order with the last message in the fifo: append it there.
+    // Otherwise fall back to the heap.
+    if (m_fifo.empty() || !(m_fifo.back() > message)) {
+        m_fifo.push_back(std::move(message));
+    } else {
+        m_prio_heap.push_back(std::move(message));
+        push_heap(m_prio_heap.begin(), m_prio_heap.end(),
+                  greater<MsgPtr>());
+    }
+}
+
+MsgPtr
+MessageBuffer::popHead()
+{
+    MsgPtr message;
+    if (headInFifo()) {
+        message = std::move(m_fifo.front());
+        m_fifo.pop_front();
+    } else {
+        pop_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
+        message = std::move(m_prio_heap.back());
+        m_prio_heap.pop_back();
+    }
+    return message;
+}
+
 void
 MessageBuffer::registerDequeueCallback(std::function<void()> callback)
 {
@@ -276,6 +302,7 @@ MessageBuffer::unregisterDequeueCallback()
 void
 MessageBuffer::clear()
 {
+    m_fifo.clear();
     m_prio_heap.clear();
 
     m_msg_counter = 0;
@@ -291,14 +318,12 @@ MessageBuffer::recycle(Tick current_time, Tick recycle_latency)
 {
     DPRINTF(RubyQueue, "Recycling.\n");
     assert(isReady(current_time));
-    MsgPtr node = m_prio_heap.front();
-    pop_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
+    MsgPtr node = popHead();
 
     Tick future_time = current_time + recycle_latency;
     node->setLastEnqueueTime(future_time);
 
-    m_prio_heap.back() = node;
-    push_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
+    insertMessage(std::move(node));
     m_consumer->scheduleEventAbsolute(future_time);
 }
 
@@ -306,18 +331,16 @@ void
 MessageBuffer::reanalyzeList(list<MsgPtr> &lt, Tick schdTick)
 {
     while (!lt.empty()) {
-        MsgPtr m = lt.front();
+        MsgPtr &m = lt.front();
         assert(m->getLastEnqueueTime() <= schdTick);
 
-        m_prio_heap.push_back(m);
-        push_heap(m_prio_heap.begin(), m_prio_heap.end(),
-                  greater<MsgPtr>());
-
-        m_consumer->scheduleEventAbsolute(schdTick);
-
         DPRINTF(RubyQueue, "Requeue arrival_time: %lld, Message: %s\n",
             schdTick, *(m.get()));
 
+        insertMessage(std::move(m));
+
+        m_consumer->scheduleEventAbsolute(schdTick);
+
         lt.pop_front();
     }
 }
@@ -366,7 +389,7 @@ MessageBuffer::stallMessage(Addr addr, Tick current_time)
     DPRINTF(RubyQueue, "Stalling due to %#x\n", addr);
     assert(isReady(current_time));
     assert(getOffset(addr) == 0);
-    MsgPtr message = m_prio_heap.front();
+    MsgPtr message = headMsgPtr();
 
     // Since the message will just be moved to stall map, indicate that the
     // buffer should not decrement the m_buf_msgs statistic
@@ -391,15 +414,16 @@ MessageBuffer::print(ostream& out) const
     }
 
     vector<MsgPtr> copy(m_prio_heap);
-    sort_heap(copy.begin(), copy.end(), greater<MsgPtr>());
+    copy.insert(copy.end(), m_fifo.begin(), m_fifo.end());
+    sort(copy.begin(), copy.end(), greater<MsgPtr>());
     ccprintf(out, "%s] %s", copy, name());
 }
 
 bool
 MessageBuffer::isReady(Tick current_time) const
 {
-    return ((m_prio_heap.size() > 0) &&
-        (m_prio_heap.front()->getLastEnqueueTime() <= current_time));
+    return (!isEmpty() &&
+        (headMsgPtr()->getLastEnqueueTime() <= current_time));
 }
 
 void
@@ -442,8 +466,15 @@ MessageBuffer::functionalWrite(Packet *pkt)
 {
     uint32_t num_functional_writes = 0;
 
-    // Check the priority heap and write any messages that may
-    // correspond to the address in the packet.
+    // Check the queued messages and write any that may correspond to
+    // the address in the packet.
+    for (unsigned int i = 0; i < m_fifo.size(); ++i) {
+        Message *msg = m_fifo[i].get();
+        if (msg->functionalWrite(pkt)) {
+            num_functional_writes++;
+        }
+    }
+
     for (unsigned int i = 0; i < m_prio_heap.size(); ++i) {
         Message *msg = m_prio_heap[i].get();
         if (msg->functionalWrite(pkt)) {
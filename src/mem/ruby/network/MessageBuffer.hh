@@ -36,6 +36,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <deque>
 #include <functional>
 #include <iostream>
 #include <string>
@@ -68,10 +69,7 @@ class MessageBuffer : public SimObject
     void
     delayHead(Tick current_time, Tick delta)
     {
-        MsgPtr m = m_prio_heap.front();
-        std::pop_heap(m_prio_heap.begin(), m_prio_heap.end(),
-                      std::greater<MsgPtr>());
-        m_prio_heap.pop_back();
+        MsgPtr m = popHead();
         enqueue(m, current_time, delta);
     }
 
@@ -97,7 +95,7 @@ class MessageBuffer : public SimObject
     //! message queue.  The function assumes that the queue is nonempty.
     const Message* peek() const;
 
-    const MsgPtr &peekMsgPtr() const { return m_prio_heap.front(); }
+    const MsgPtr &peekMsgPtr() const { return headMsgPtr(); }
 
     void enqueue(MsgPtr message, Tick curTime, Tick delta);
 
@@ -109,7 +107,7 @@ class MessageBuffer : public SimObject
     void unregisterDequeueCallback();
 
     void recycle(Tick current_time, Tick recycle_latency);
-    bool isEmpty() const { return m_prio_heap.size() == 0; }
+    bool isEmpty() const { return m_fifo.empty() && m_prio_heap.empty(); }
     bool isStallMapEmpty() { return m_stall_msg_map.size() == 0; }
     unsigned int getStallMapSize() { return m_stall_msg_map.size(); }
 
@@ -139,10 +137,44 @@ class MessageBuffer : public SimObject
   private:
     void reanalyzeList(std::list<MsgPtr> &, Tick);
 
+    // Messages waiting in the buffer, whichever queue holds them
+    unsigned int
+    queueSize() const
+    {
+        return m_fifo.size() + m_prio_heap.size();
+    }
+
+    // The earliest message is at the front of one of the two queues
+    bool
+    headInFifo() const
+    {
+        return m_prio_heap.empty() ||
+            (!m_fifo.empty() && m_prio_heap.front() > m_fifo.front());
+    }
+
+    const MsgPtr &
+    headMsgPtr() const
+    {
+        return headInFifo() ? m_fifo.front() : m_prio_heap.front();
+    }
+
+    void insertMessage(MsgPtr message);
+    MsgPtr popHead();
+
   private:
     // Data Members (m_ prefix)
     //! Consumer to signal a wakeup(), can be NULL
     Consumer* m_consumer;
+
+    /**
+     * Messages are kept in arrival order. Most buffers see messages
+     * arrive in non-decreasing order, so a message that does not arrive
+     * before the last one in m_fifo is appended there, in constant time.
+     * Only messages that would arrive out of order (recycled, reanalyzed
+     * or randomly delayed ones) go to the m_prio_heap, and the head of
+     * the buffer is the earlier of the heads of the two.
+     */
+    std::deque<MsgPtr> m_fifo;
     std::vector<MsgPtr> m_prio_heap;
 
     std::function<void()> m_dequeue_callback;
@@ -154,14 +186,14 @@ class MessageBuffer : public SimObject
     /**
      * A map from line addresses to lists of stalled messages for that line.
      * If this buffer allows the receiver to stall messages, on a stall
-     * request, the stalled message is removed from the m_prio_heap and placed
+     * request, the stalled message is removed from the buffer and placed
      * in the m_stall_msg_map. Messages are held there until the receiver
      * requests they be reanalyzed, at which point they are moved back to
-     * m_prio_heap.
+     * the buffer.
      *
      * NOTE: The stall map holds messages in the order in which they were
      * initially received, and when a line is unblocked, the messages are
-     * moved back to the m_prio_heap in the same order. This prevents starving
+     * moved back to the buffer in the same order. This prevents starving
      * older requests with younger ones.
      */
     StallMsgMapType m_stall_msg_map;
@@ -170,7 +202,7 @@ class MessageBuffer : public SimObject
      * Current size of the stall map.
      * Track the number of messages held in stall map lists. This is used to
      * ensure that if the buffer is finite-sized, it blocks further requests
-     * when the m_prio_heap and m_stall_msg_map contain m_max_size messages.
+     * when the buffer and m_stall_msg_map contain m_max_size messages.
      */
     int m_stall_map_size;
 
@@ -29,6 +29,8 @@
 #include "mem/ruby/network/Topology.hh"
 
 #include <cassert>
+#include <functional>
+#include <queue>
 
 #include "base/trace.hh"
 #include "debug/RubyNetwork.hh"
@@ -117,43 +119,31 @@ Topology::createLinks(Network *net)
         max_switch_id = max(max_switch_id, src_dest.second);
     }
 
-    // Initialize weight, latency, and inter switched vectors
-    int num_switches = max_switch_id+1;
-    Matrix topology_weights(num_switches,
-            vector<int>(num_switches, INFINITE_LATENCY));
-    Matrix component_latencies(num_switches,
-            vector<int>(num_switches, -1));
-    Matrix component_inter_switches(num_switches,
-            vector<int>(num_switches, 0));
-
-    // Set identity weights to zero
-    for (int i = 0; i < topology_weights.size(); i++) {
-        topology_weights[i][i] = 0;
-    }
-
-    // Fill in the topology weights and bandwidth multipliers
+    // Links into each switch
+    InLinks in_links(max_switch_id + 1);
     for (LinkMap::const_iterator i = m_link_map.begin();
          i != m_link_map.end(); ++i) {
-        std::pair<int, int> src_dest = (*i).first;
-        BasicLink* link = (*i).second.link;
-        int src = src_dest.first;
-        int dst = src_dest.second;
-        component_latencies[src][dst] = link->m_latency;
-        topology_weights[src][dst] = link->m_weight;
+        int src = (*i).first.first;
+        int dst = (*i).first.second;
+        if (src != dst)
+            in_links[dst].push_back(std::make_pair((*i).second.link->m_weight,
+                                                   src));
     }
 
     // Walk topology and hookup the links
-    Matrix dist = shortest_path(topology_weights, component_latencies,
-                                component_inter_switches);
-
-    for (int i = 0; i < topology_weights.size(); i++) {
-        for (int j = 0; j < topology_weights[i].size(); j++) {
-            int weight = topology_weights[i][j];
-            if (weight > 0 && weight != INFINITE_LATENCY) {
-                NetDest destination_set =
-                        shortest_path_to_node(i, j, topology_weights, dist);
-                makeLink(net, i, j, destination_set);
-            }
+    Matrix dist = shortest_path(m_nodes, in_links);
+
+    // (the link map is ordered by (src, dest), so links are made in
+    //  the same order as walking a weight matrix row by row)
+    for (LinkMap::const_iterator i = m_link_map.begin();
+         i != m_link_map.end(); ++i) {
+        int src = (*i).first.first;
+        int dst = (*i).first.second;
+        int weight = (*i).second.link->m_weight;
+        if (weight > 0 && weight != INFINITE_LATENCY) {
+            NetDest destination_set =
+                    shortest_path_to_node(src, dst, weight, dist);
+            makeLink(net, src, dst, destination_set);
         }
     }
 }
@@ -215,66 +205,64 @@ Topology::makeLink(Network *net, SwitchID src, SwitchID dest,
     }
 }
 
-// The following all-pairs shortest path algorithm is based on the
-// discussion from Cormen et al., Chapter 26.1.
-void
-Topology::extend_shortest_path(Matrix &current_dist, Matrix &latencies,
-    Matrix &inter_switches)
+// Shortest distance from every switch to every destination node, as
+// dist[node][switch]. The routing tables only need the distances to the
+// destination switches, so this runs one Dijkstra search per node over
+// the reversed links rather than relaxing all pairs of switches until
+// nothing changes. Distances are capped at INFINITE_LATENCY, as the
+// all-pairs relaxation did.
+Matrix
+Topology::shortest_path(int num_nodes, const InLinks &in_links)
 {
-    bool change = true;
-    int nodes = current_dist.size();
-
-    while (change) {
-        change = false;
-        for (int i = 0; i < nodes; i++) {
-            for (int j = 0; j < nodes; j++) {
-                int minimum = current_dist[i][j];
-                int previous_minimum = minimum;
-                int intermediate_switch = -1;
-                for (int k = 0; k < nodes; k++) {
-                    minimum = min(minimum,
-                        current_dist[i][k] + current_dist[k][j]);
-                    if (previous_minimum != minimum) {
-                        intermediate_switch = k;
-                        inter_switches[i][j] =
-                            inter_switches[i][k] +
-                            inter_switches[k][j] + 1;
-                    }
-                    previous_minimum = minimum;
-                }
-                if (current_dist[i][j] != minimum) {
-                    change = true;
-                    current_dist[i][j] = minimum;
-                    assert(intermediate_switch >= 0);
-                    assert(intermediate_switch < latencies[i].size());
-                    latencies[i][j] = latencies[i][intermediate_switch] +
-                        latencies[intermediate_switch][j];
+    typedef std::pair<int, SwitchID> DistSwitch;
+
+    const int num_switches = in_links.size();
+    Matrix dist(num_nodes, vector<int>(num_switches, INFINITE_LATENCY));
+    std::priority_queue<DistSwitch, std::vector<DistSwitch>,
+                        std::greater<DistSwitch> > queue;
+
+    for (int node = 0; node < num_nodes; node++) {
+        // the destination switches for the machines are numbered
+        // [num_nodes ... 2*num_nodes-1] (see shortest_path_to_node)
+        SwitchID final = node + num_nodes;
+        if (final >= num_switches)
+            continue;
+
+        std::vector<int>& node_dist = dist[node];
+        node_dist[final] = 0;
+        queue.push(DistSwitch(0, final));
+
+        while (!queue.empty()) {
+            DistSwitch top = queue.top();
+            queue.pop();
+            SwitchID sw = top.second;
+            if (top.first > node_dist[sw])
+                continue;
+
+            for (const DistSwitch& link : in_links[sw]) {
+                int d = min(top.first + link.first, INFINITE_LATENCY);
+                if (d < node_dist[link.second]) {
+                    node_dist[link.second] = d;
+                    queue.push(DistSwitch(d, link.second));
                 }
             }
         }
     }
-}
 
-Matrix
-Topology::shortest_path(const Matrix &weights, Matrix &latencies,
-                        Matrix &inter_switches)
-{
-    Matrix dist = weights;
-    extend_shortest_path(dist, latencies, inter_switches);
     return dist;
 }
 
 bool
 Topology::link_is_shortest_path_to_node(SwitchID src, SwitchID next,
-                                        SwitchID final, const Matrix &weights,
+                                        int weight, NodeID node,
                                         const Matrix &dist)
 {
-    return weights[src][next] + dist[next][final] == dist[src][final];
+    return weight + dist[node][next] == dist[node][src];
 }
 
 NetDest
-Topology::shortest_path_to_node(SwitchID src, SwitchID next,
-                                const Matrix &weights, const Matrix &dist)
+Topology::shortest_path_to_node(SwitchID src, SwitchID next, int weight,
+                                const Matrix &dist)
 {
     NetDest result;
     int d = 0;
@@ -286,13 +274,12 @@ Topology::shortest_path_to_node(SwitchID src, SwitchID next,
 
     for (int m = 0; m < machines; m++) {
         for (NodeID i = 0; i < MachineType_base_count((MachineType)m); i++) {
-            // we use "d+max_machines" below since the "destination"
-            // switches for the machines are numbered
+            // the "destination" switches for the machines are numbered
             // [MachineType_base_number(MachineType_NUM)...
             //  2*MachineType_base_number(MachineType_NUM)-1] for the
-            // component network
-            if (link_is_shortest_path_to_node(src, next, d + max_machines,
-                    weights, dist)) {
+            // component network; dist is indexed by d directly
+            if (link_is_shortest_path_to_node(src, next, weight, d,
+                                              dist)) {
                 MachineID mach = {(MachineType)m, i};
                 result.add(mach);
             }
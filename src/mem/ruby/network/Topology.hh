@@ -73,6 +73,13 @@ class Topology
     void createLinks(Network *net);
     void print(std::ostream& out) const { out << "[Topology]"; }
 
+    // Links into each switch, as (weight, source switch)
+    typedef std::vector<std::vector<std::pair<int, SwitchID> > > InLinks;
+
+    // Distances from every switch to the destination switch of each of
+    // the num_nodes nodes, dist[node][switch]
+    static Matrix shortest_path(int num_nodes, const InLinks &in_links);
+
   private:
     void addLink(SwitchID src, SwitchID dest, BasicLink* link,
                  PortDirection src_outport_dirn = "",
@@ -80,18 +87,11 @@ class Topology
     void makeLink(Network *net, SwitchID src, SwitchID dest,
                   const NetDest& routing_table_entry);
 
-    // Helper functions based on chapter 29 of Cormen et al.
-    void extend_shortest_path(Matrix &current_dist, Matrix &latencies,
-                              Matrix &inter_switches);
-
-    std::vector<std::vector<int>> shortest_path(const Matrix &weights,
-            Matrix &latencies, Matrix &inter_switches);
-
     bool link_is_shortest_path_to_node(SwitchID src, SwitchID next,
-            SwitchID final, const Matrix &weights, const Matrix &dist);
+            int weight, NodeID node, const Matrix &dist);
 
-    NetDest shortest_path_to_node(SwitchID src, SwitchID next,
-                                  const Matrix &weights, const Matrix &dist);
+    NetDest shortest_path_to_node(SwitchID src, SwitchID next, int weight,
+                                  const Matrix &dist);
 
     const uint32_t m_nodes;
     const uint32_t m_number_of_switches;
@@ -34,7 +34,11 @@
 #ifndef __MEM_RUBY_NETWORK_GARNET2_0_COMMONTYPES_HH__
 #define __MEM_RUBY_NETWORK_GARNET2_0_COMMONTYPES_HH__
 
+#include <utility>
+#include <vector>
+
 #include "mem/ruby/common/NetDest.hh"
+#include "mem/ruby/common/ObjectPool.hh"
 #include "mem/ruby/network/Network.hh"
 
 // All common enums and typedefs go here
@@ -45,7 +49,22 @@ enum VNET_type {CTRL_VNET_, DATA_VNET_, NULL_VNET_, NUM_VNET_TYPE_};
 enum flit_stage {I_, VA_, SA_, ST_, LT_, NUM_FLIT_STAGE_};
 enum link_type { EXT_IN_, EXT_OUT_, INT_, NUM_LINK_TYPES_ };
 enum RoutingAlgorithm { TABLE_ = 0, XY_ = 1, CUSTOM_ = 2,
+                        WEST_FIRST_ = 3, ODD_EVEN_ = 4,
                         NUM_ROUTING_ALGORITHM_};
+enum SMARTPriority { SMART_PRIO_CLOSEST_ = 0, SMART_PRIO_FARTHEST_ = 1,
+                     NUM_SMART_PRIO_ };
+enum PoolType { FLIT_POOL_, CREDIT_POOL_, ROUTE_POOL_, NUM_POOL_TYPES_ };
+
+// Port directions are interned into small integers when the topology is
+// built (see GarnetNetwork::getPortDirectionId), so that the per-flit
+// route computation and SSR handling index arrays instead of comparing
+// strings. The mesh directions have fixed ids; any other direction name
+// in the topology file gets the next free id up to MAX_PORT_DIRNS_.
+// The direction strings are only kept for config parsing and printing.
+enum PortDirectionId { UNKNOWN_DIRN_ = -1,
+                       LOCAL_ = 0, NORTH_ = 1, SOUTH_ = 2, EAST_ = 3,
+                       WEST_ = 4, NUM_MESH_DIRNS_ = 5,
+                       MAX_PORT_DIRNS_ = 32 };
 
 // :std::string* portname = new string[4]{"North", "South", "East", "West"};
 /*
@@ -63,12 +82,16 @@ struct RouteInfo
     int hops_traversed;
     int x_hops_remaining;
     int y_hops_remaining;
-    PortDirection outport_dirn;
+    PortDirectionId outport_dirn;
     int smart_hops_traversed;
 };
 */
 
-class RouteInfo{
+// Most routers a minimal adaptive route can cross, which is
+// (rows - 1) + (cols - 1) + 1 on a mesh
+#define MAX_ADAPTIVE_ROUTERS_ 32
+
+class RouteInfo : public PooledObject<RouteInfo> {
     public:
         RouteInfo(){
             vnet = -1;
@@ -79,9 +102,9 @@ class RouteInfo{
             hops_traversed = -1;
             x_hops_remaining = -1;
             y_hops_remaining = -1;
-            outport_dirn = "Local";
+            outport_dirn = LOCAL_;
             smart_hops_traversed = -1;
-
+            num_adaptive_dirns = 0;
         }
 
         int vnet;
@@ -95,9 +118,17 @@ class RouteInfo{
         int hops_traversed;
         int x_hops_remaining;
         int y_hops_remaining;
-        PortDirection outport_dirn;
+        PortDirectionId outport_dirn;
         int smart_hops_traversed;
 
+        // Adaptive routing with SMART: the direction the packet leaves
+        // each router through. The head flit decides it, when its SSR
+        // reaches the router or when it is routed there, and the body
+        // and tail flits reuse it so the packet stays on one path.
+        // A minimal route crosses at most MAX_ADAPTIVE_ROUTERS_ routers
+        // (see GarnetNetwork::init).
+        std::pair<int, PortDirectionId> adaptive_dirns[MAX_ADAPTIVE_ROUTERS_];
+        int num_adaptive_dirns;
 };
 
 #define INFINITE_ 10000
@@ -38,6 +38,7 @@
 #include <iostream>
 
 #include "base/types.hh"
+#include "mem/ruby/common/ObjectPool.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
 #include "mem/ruby/network/garnet2.0/flit.hh"
 
@@ -45,9 +46,13 @@
 // Carries m_vc (inherits from flit.hh)
 // and m_is_free_signal (whether VC is free or not)
 
-class Credit : public flit
+class Credit : public flit, public PooledObject<Credit>
 {
   public:
+    // Credits have their own pool, not the flit one
+    using PooledObject<Credit>::operator new;
+    using PooledObject<Credit>::operator delete;
+
     Credit() {};
     Credit(int vc, bool is_free_signal, Cycles curTime, int pid, int id);
     // void print(std::ostream& out) const;
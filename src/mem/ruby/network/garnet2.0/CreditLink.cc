@@ -63,7 +63,10 @@ CreditLink::wakeup()
     while (link_srcQueue->isReady(curCycle())) {
         flit *t_flit = link_srcQueue->getTopFlit();
         t_flit->set_time(curCycle() + m_latency);
-        linkBuffer->insert(t_flit);
+        {
+            BufferLock lock(this);
+            linkBuffer->insert(t_flit);
+        }
         link_consumer->scheduleEventAbsolute(clockEdge(m_latency));
         m_link_utilized++;
         m_vc_load[t_flit->get_vc()]++;
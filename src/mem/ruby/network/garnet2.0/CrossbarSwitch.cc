@@ -91,7 +91,7 @@ CrossbarSwitch::wakeup()
             int outport = t_flit->get_outport();
 
         DPRINTF(RubyNetwork, "Crossbar Switch at Router %d "
-                "sending flit %s from outport %d at time: %lld\n",
+                "sending flit %s from outport %s at time: %lld\n",
                 m_router->get_id(), *t_flit,
                 m_router->getPortDirectionName(
                     m_output_unit[outport]->get_direction()),
@@ -112,6 +112,10 @@ CrossbarSwitch::wakeup()
             if (t_flit->get_route()->dest_router != m_router->get_id()) {
                 t_flit->increment_hops();
                 t_flit->increment_smart_hops();
+
+                // the previous smart hop ended in this router's buffer
+                m_router->sample_smart_hop(t_flit->end_smart_hop());
+                t_flit->start_smart_hop();
             }
         }
     }
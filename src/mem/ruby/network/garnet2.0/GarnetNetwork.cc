@@ -33,14 +33,21 @@
 
 #include "mem/ruby/network/garnet2.0/GarnetNetwork.hh"
 
+#include <algorithm>
 #include <cassert>
 
+#include "base/callback.hh"
 #include "base/cast.hh"
+#include "base/cprintf.hh"
+#include "base/logging.hh"
+#include "base/output.hh"
 #include "base/stl_helpers.hh"
+#include "config/have_protobuf.hh"
 #include "debug/FlitOrder.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/network/MessageBuffer.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
+#include "mem/ruby/network/garnet2.0/Credit.hh"
 #include "mem/ruby/network/garnet2.0/CreditLink.hh"
 #include "mem/ruby/network/garnet2.0/GarnetLink.hh"
 #include "mem/ruby/network/garnet2.0/NetworkInterface.hh"
@@ -48,10 +55,20 @@
 #include "mem/ruby/network/garnet2.0/Router.hh"
 #include "mem/ruby/network/garnet2.0/SSR.hh"
 #include "mem/ruby/system/RubySystem.hh"
+#include "sim/core.hh"
+
+#if HAVE_PROTOBUF
+#include "proto/network_trace.pb.h"
+#include "proto/protoio.hh"
+#endif
 
 using namespace std;
 using m5::stl_helpers::deletePointers;
 
+// The packet latency percentiles reported, and the names of their stats
+static const double latencyPercentiles[] = { 0.5, 0.99, 0.999 };
+static const char *latencyPercentileNames[] = { "p50", "p99", "p999" };
+
 /*
  * GarnetNetwork sets up the routers and links and collects stats.
  * Default parameters (GarnetNetwork.py) can be overwritten from command line
@@ -71,12 +88,23 @@ GarnetNetwork::GarnetNetwork(const Params *p)
     m_enable_smart = p->enable_smart;
     m_smart_hpcmax = p->smart_hpcmax;
     m_smart_dest_bypass = p->smart_dest_bypass;
+    m_smart_2d = p->smart_2d;
+    fatal_if(p->smart_priority < 0 || p->smart_priority >= NUM_SMART_PRIO_,
+             "Unknown SMART priority %d\n", p->smart_priority);
+    m_smart_priority = (SMARTPriority) p->smart_priority;
 
     m_enable_fault_model = p->enable_fault_model;
     if (m_enable_fault_model)
         fault_model = p->fault_model;
 
+    // The mesh directions always get the same ids
+    m_port_dirn_names = { "Local", "North", "South", "East", "West" };
+    assert(m_port_dirn_names.size() == NUM_MESH_DIRNS_);
+
     m_vnet_type.resize(m_virtual_networks);
+    m_dest_latency.resize(m_nodes);
+    if (p->pair_latency_stats)
+        m_pair_latency.resize(m_nodes * m_nodes);
 
     for (int i = 0 ; i < m_virtual_networks ; i++) {
         if (m_vnet_type_names[i] == "response")
@@ -94,6 +122,19 @@ GarnetNetwork::GarnetNetwork(const Params *p)
         // initialize the router's network pointers
         router->init_net_ptr(this);
     }
+    m_packets_delivered.resize(m_routers.size(), 0);
+    m_last_delivery.resize(m_routers.size(), 0);
+
+    m_trace_file = p->trace_file;
+    m_trace_stream = nullptr;
+
+    m_util_file = p->util_file;
+    m_util_interval = p->util_interval;
+    m_util_period = 0;
+    m_router_util_stream = nullptr;
+    m_link_util_stream = nullptr;
+
+    m_report_file = p->report_file;
 
     // record the network interfaces
     for (vector<ClockedObject*>::const_iterator i = p->netifs.begin();
@@ -118,6 +159,10 @@ GarnetNetwork::init()
     assert(m_topology_ptr != NULL);
     m_topology_ptr->createLinks(this);
 
+    for (int i = 0; i < m_networklinks.size(); i++) {
+        m_networklinks[i]->init_net_ptr(this);
+    }
+
     // Initialize topology specific parameters
     if (getNumRows() > 0) {
         // Only for Mesh topology
@@ -131,6 +176,20 @@ GarnetNetwork::init()
         m_num_cols = -1;
     }
 
+    fatal_if((m_routing_algorithm == XY_ ||
+              m_routing_algorithm == WEST_FIRST_ ||
+              m_routing_algorithm == ODD_EVEN_) && m_num_rows <= 0,
+             "%s: routing algorithm %d needs a mesh (num_rows > 0)\n",
+             name(), m_routing_algorithm);
+
+    // With SMART, the route of a packet keeps the direction chosen at
+    // each router of its minimal adaptive path
+    fatal_if(m_enable_smart && (m_routing_algorithm == WEST_FIRST_ ||
+                                m_routing_algorithm == ODD_EVEN_) &&
+             m_num_rows + m_num_cols - 1 > MAX_ADAPTIVE_ROUTERS_,
+             "%s: adaptive SMART routing supports meshes of up to %d "
+             "routers across\n", name(), MAX_ADAPTIVE_ROUTERS_);
+
     // FaultModel: declare each router to the fault model
     if (isFaultModelEnabled()) {
         for (vector<Router*>::const_iterator i= m_routers.begin();
@@ -147,6 +206,257 @@ GarnetNetwork::init()
             router->printFaultVector(cout);
         }
     }
+
+    // Network trace: one packet per destination, at NI injection
+    if (m_trace_file != "") {
+#if HAVE_PROTOBUF
+        m_trace_stream = new ProtoOutputStream(simout.resolve(m_trace_file));
+
+        ProtoMessage::NetworkTraceHeader header_msg;
+        header_msg.set_obj_id(name());
+        header_msg.set_tick_freq(SimClock::Frequency);
+        header_msg.set_num_routers(m_routers.size());
+        m_trace_stream->write(header_msg);
+
+        // The destructor is not called at exit: flush and close the
+        // trace from an exit callback instead
+        registerExitCallback(new MakeCallback<GarnetNetwork,
+                             &GarnetNetwork::closeTraceStream>(this));
+#else
+        fatal("%s: recording a network trace requires protobuf support\n",
+              name());
+#endif
+    }
+
+    // Utilization time series, one row per router and per link at
+    // every sample
+    if (m_util_file != "") {
+        fatal_if(m_util_interval == 0,
+                 "%s: util_interval must be non-zero\n", name());
+
+        std::string base = m_util_file;
+        std::string suffix = ".csv";
+        if (base.size() > 3 && base.compare(base.size() - 3, 3, ".gz") == 0) {
+            base.resize(base.size() - 3);
+            suffix += ".gz";
+        }
+
+        m_router_util_stream = simout.create(base + ".routers" + suffix);
+        ccprintf(*m_router_util_stream->stream(),
+                 "tick,router,vc_occupancy,sa_requests,sa_grants,"
+                 "smart_tries,smart_bypasses\n");
+
+        m_link_util_stream = simout.create(base + ".links" + suffix);
+        ccprintf(*m_link_util_stream->stream(),
+                 "tick,type,src,dest,flits,utilization\n");
+
+        m_util_period = cyclesToTicks(m_util_interval);
+
+        registerExitCallback(new MakeCallback<GarnetNetwork,
+                             &GarnetNetwork::closeUtilizationStreams>(this));
+    }
+
+    if (m_report_file != "") {
+        registerExitCallback(new MakeCallback<GarnetNetwork,
+                             &GarnetNetwork::writeReport>(this));
+    }
+}
+
+void
+GarnetNetwork::recordTrace(int src_ni, int dest_ni, int vnet, int num_flits,
+                           Tick ready_time)
+{
+#if HAVE_PROTOBUF
+    int src_router = get_router_id(src_ni);
+
+    ProtoMessage::NetworkTracePacket pkt_msg;
+    pkt_msg.set_tick(ready_time);
+    pkt_msg.set_src_router(src_router);
+    pkt_msg.set_dest_router(get_router_id(dest_ni));
+    pkt_msg.set_vnet(vnet);
+    pkt_msg.set_size(num_flits);
+    pkt_msg.set_src_ni(src_ni);
+    pkt_msg.set_dest_ni(dest_ni);
+    pkt_msg.set_num_received(m_packets_delivered[src_router]);
+    if (m_packets_delivered[src_router] > 0 &&
+        ready_time > m_last_delivery[src_router]) {
+        pkt_msg.set_gap(ready_time - m_last_delivery[src_router]);
+    }
+
+    m_trace_stream->write(pkt_msg);
+#endif
+}
+
+void
+GarnetNetwork::closeTraceStream()
+{
+#if HAVE_PROTOBUF
+    delete m_trace_stream;
+    m_trace_stream = nullptr;
+#endif
+}
+
+// vc_occupancy: flits held in the input VCs, averaged over the window.
+// sa_requests/sa_grants: inport requests that won switch allocation at
+// the input stage / outport grants; their difference is SA contention.
+// smart_tries/smart_bypasses: flits that arrived over router links and
+// tried to bypass the router / did so.
+void
+GarnetNetwork::recordRouterUtilization(int router, double vc_occupancy,
+                                       double sa_requests, double sa_grants,
+                                       uint64_t smart_tries,
+                                       uint64_t smart_bypasses)
+{
+    std::lock_guard<std::mutex> lock(m_util_mutex);
+    ccprintf(*m_router_util_stream->stream(), "%d,%d,%.3f,%d,%d,%d,%d\n",
+             curTick(), router, vc_occupancy, (uint64_t)sa_requests,
+             (uint64_t)sa_grants, smart_tries, smart_bypasses);
+}
+
+// src and dest are router ids, or NI ids at the NI end of an external
+// link; utilization is flits per link cycle.
+void
+GarnetNetwork::recordLinkUtilization(const NetworkLink *link,
+                                     uint64_t flits, Cycles window)
+{
+    static const char *type_names[NUM_LINK_TYPES_] =
+        { "ext_in", "ext_out", "int" };
+
+    std::lock_guard<std::mutex> lock(m_util_mutex);
+    ccprintf(*m_link_util_stream->stream(), "%d,%s,%d,%d,%d,%.3f\n",
+             curTick(), type_names[link->getType()], link->get_src(),
+             link->get_dest(), flits,
+             window > 0 ? double(flits) / window : 0.0);
+}
+
+void
+GarnetNetwork::closeUtilizationStreams()
+{
+    std::lock_guard<std::mutex> lock(m_util_mutex);
+    simout.close(m_router_util_stream);
+    simout.close(m_link_util_stream);
+    m_router_util_stream = nullptr;
+    m_link_util_stream = nullptr;
+    m_util_period = 0;
+}
+
+// Router activity since the last stats reset, as heatmaps laid out
+// like the mesh (router 0 in the bottom left corner), and the flit links
+// with the highest utilization.
+void
+GarnetNetwork::writeReport()
+{
+    const int num_top_links = 10;
+
+    RubySystem *rs = params()->ruby_system;
+    double time_delta = double(curCycle() - rs->getStartCycle());
+    int num_routers = m_routers.size();
+
+    OutputStream *os = simout.create(m_report_file);
+    std::ostream &out = *os->stream();
+
+    ccprintf(out, "Garnet network report: %d routers, %d cycles\n\n",
+             num_routers, (uint64_t)time_delta);
+
+    vector<double> buffer_reads(num_routers);
+    vector<double> buffer_writes(num_routers);
+    vector<double> crossbar(num_routers);
+    vector<double> link_util(num_routers, 0);
+    vector<double> smart_hops(num_routers, 0);
+    vector<double> smart_hop_routers(num_routers, 0);
+
+    for (int i = 0; i < num_routers; i++) {
+        buffer_reads[i] = m_routers[i]->get_buffer_reads();
+        buffer_writes[i] = m_routers[i]->get_buffer_writes();
+        crossbar[i] = m_routers[i]->get_crossbar_activity();
+
+        const vector<uint64_t>& counts =
+            m_routers[i]->get_smart_hop_counts();
+        double routers = 0;
+        for (int n = 0; n < counts.size(); n++) {
+            smart_hops[i] += counts[n];
+            routers += double(n) * counts[n];
+        }
+        if (smart_hops[i] > 0)
+            smart_hop_routers[i] = routers / smart_hops[i];
+    }
+
+    // Busiest outgoing link of each router
+    auto utilization = [time_delta](const NetworkLink *link) {
+        return time_delta > 0 ? link->getLinkUtilization() / time_delta : 0;
+    };
+    for (int i = 0; i < m_networklinks.size(); i++) {
+        const NetworkLink *link = m_networklinks[i];
+        if (link->getType() != EXT_IN_) {
+            int src = link->get_src();
+            link_util[src] = std::max(link_util[src], utilization(link));
+        }
+    }
+
+    printHeatmap(out, "Buffer reads", buffer_reads);
+    printHeatmap(out, "Buffer writes", buffer_writes);
+    printHeatmap(out, "Crossbar activity", crossbar);
+    printHeatmap(out, "Highest outgoing link utilization (flits/cycle)",
+                 link_util);
+    if (isSMART()) {
+        printHeatmap(out, "SMART hops ending at the router", smart_hops);
+        printHeatmap(out, "Routers per SMART hop ending at the router",
+                     smart_hop_routers);
+    }
+
+    // Bottleneck links
+    vector<const NetworkLink *> links(m_networklinks.begin(),
+                                      m_networklinks.end());
+    int num_links = std::min<int>(num_top_links, links.size());
+    std::partial_sort(links.begin(), links.begin() + num_links,
+                      links.end(),
+        [&utilization](const NetworkLink *a, const NetworkLink *b) {
+            return utilization(a) > utilization(b);
+        });
+
+    static const char *type_names[NUM_LINK_TYPES_] =
+        { "NI -> router", "router -> NI", "router -> router" };
+
+    ccprintf(out, "Busiest links (src and dest are NI ids at the NI end)\n");
+    ccprintf(out, "%4s  %-16s %6s %6s %12s %12s\n", "rank", "type",
+             "src", "dest", "flits", "flits/cycle");
+    for (int i = 0; i < num_links; i++) {
+        const NetworkLink *link = links[i];
+        ccprintf(out, "%4d  %-16s %6d %6d %12d %12.4f\n", i + 1,
+                 type_names[link->getType()], link->get_src(),
+                 link->get_dest(), link->getLinkUtilization(),
+                 utilization(link));
+    }
+
+    simout.close(os);
+}
+
+void
+GarnetNetwork::printHeatmap(std::ostream& out, const std::string& title,
+                            const vector<double>& values) const
+{
+    // Shade of each cell, from lowest to highest value
+    static const char shades[] = " .:-=+*#%@";
+    const int num_shades = sizeof(shades) - 1;
+
+    int num_cols = (m_num_cols > 0) ? m_num_cols : 8;
+    int num_rows = (values.size() + num_cols - 1) / num_cols;
+    double max_value = *std::max_element(values.begin(), values.end());
+
+    ccprintf(out, "%s (max %.4g)\n", title, max_value);
+    for (int row = num_rows - 1; row >= 0; row--) {
+        ccprintf(out, "%5d |", row * num_cols);
+        for (int col = 0; col < num_cols; col++) {
+            int router = row * num_cols + col;
+            if (router >= values.size())
+                break;
+            int shade = (max_value > 0) ?
+                values[router] / max_value * (num_shades - 1) : 0;
+            ccprintf(out, " %10.4g %c", values[router], shades[shade]);
+        }
+        ccprintf(out, "\n");
+    }
+    ccprintf(out, "\n");
 }
 
 GarnetNetwork::~GarnetNetwork()
@@ -155,6 +465,10 @@ GarnetNetwork::~GarnetNetwork()
     deletePointers(m_nis);
     deletePointers(m_networklinks);
     deletePointers(m_creditlinks);
+    deletePointers(m_packet_network_latency_hist);
+    deletePointers(m_packet_queueing_latency_hist);
+    deletePointers(m_packet_latency_percentiles);
+    deletePointers(m_pair_latency_percentiles);
 }
 
 /*
@@ -175,14 +489,17 @@ GarnetNetwork::makeExtInLink(NodeID src, SwitchID dest, BasicLink* link,
     // GarnetExtLink is bi-directional
     NetworkLink* net_link = garnet_link->m_network_links[LinkDirection_In];
     net_link->setType(EXT_IN_);
+    net_link->setEnds(src, dest);
     CreditLink* credit_link = garnet_link->m_credit_links[LinkDirection_In];
 
     m_networklinks.push_back(net_link);
     m_creditlinks.push_back(credit_link);
 
-    PortDirection dst_inport_dirn = "Local";
-    m_routers[dest]->addInPort(dst_inport_dirn, net_link, credit_link);
+    m_routers[dest]->addInPort(LOCAL_, net_link, credit_link);
     m_nis[src]->addOutPort(net_link, credit_link, dest);
+
+    setCrossQueue(net_link, m_routers[dest]);
+    setCrossQueue(credit_link, m_nis[src]);
 }
 
 /*
@@ -204,16 +521,19 @@ GarnetNetwork::makeExtOutLink(SwitchID src, NodeID dest, BasicLink* link,
     // GarnetExtLink is bi-directional
     NetworkLink* net_link = garnet_link->m_network_links[LinkDirection_Out];
     net_link->setType(EXT_OUT_);
+    net_link->setEnds(src, dest);
     CreditLink* credit_link = garnet_link->m_credit_links[LinkDirection_Out];
 
     m_networklinks.push_back(net_link);
     m_creditlinks.push_back(credit_link);
 
-    PortDirection src_outport_dirn = "Local";
-    m_routers[src]->addOutPort(src_outport_dirn, net_link,
+    m_routers[src]->addOutPort(LOCAL_, net_link,
                                routing_table_entry,
                                link->m_weight, credit_link);
     m_nis[dest]->addInPort(net_link, credit_link);
+
+    setCrossQueue(net_link, m_nis[dest]);
+    setCrossQueue(credit_link, m_routers[src]);
 }
 
 /*
@@ -232,15 +552,53 @@ GarnetNetwork::makeInternalLink(SwitchID src, SwitchID dest, BasicLink* link,
     // GarnetIntLink is unidirectional
     NetworkLink* net_link = garnet_link->m_network_link;
     net_link->setType(INT_);
+    net_link->setEnds(src, dest);
     CreditLink* credit_link = garnet_link->m_credit_link;
 
     m_networklinks.push_back(net_link);
     m_creditlinks.push_back(credit_link);
 
-    m_routers[dest]->addInPort(dst_inport_dirn, net_link, credit_link);
-    m_routers[src]->addOutPort(src_outport_dirn, net_link,
+    PortDirectionId inport_dirn = getPortDirectionId(dst_inport_dirn);
+    PortDirectionId outport_dirn = getPortDirectionId(src_outport_dirn);
+
+    m_routers[dest]->addInPort(inport_dirn, net_link, credit_link);
+    m_routers[src]->addOutPort(outport_dirn,
+                               net_link,
                                routing_table_entry,
                                link->m_weight, credit_link);
+
+    setCrossQueue(net_link, m_routers[dest]);
+    setCrossQueue(credit_link, m_routers[src]);
+
+    // Record the link for SSR traversal
+    if (m_ssr_links.size() != m_routers.size()) {
+        SSRLink no_link = { -1, UNKNOWN_DIRN_ };
+        m_ssr_links.assign(m_routers.size(),
+                           std::vector<SSRLink>(MAX_PORT_DIRNS_, no_link));
+    }
+    m_ssr_links[src][outport_dirn].dest = dest;
+    m_ssr_links[src][outport_dirn].inport_dirn = inport_dirn;
+}
+
+/*
+ * Routers may be spread over several event queues (one host thread
+ * each, see --network-threads in configs/network/Network.py).
+ * Routers only talk to each other through links, with the link latency
+ * as lookahead, so a link is the only object shared by two threads.
+ * NIs stay on the event queue of the controllers they serve.
+*/
+
+void
+GarnetNetwork::setCrossQueue(NetworkLink *link, EventManager *consumer)
+{
+    bool cross_queue = (link->eventQueue() != consumer->eventQueue());
+    link->setCrossQueue(cross_queue);
+
+    if (cross_queue) {
+        // SMART moves a flit through several routers in one cycle
+        fatal_if(m_enable_smart,
+                 "SMART needs all routers on the same event queue\n");
+    }
 }
 
 // Total routers in the network
@@ -257,6 +615,33 @@ GarnetNetwork::get_router_id(int ni)
     return m_nis[ni]->get_router_id();
 }
 
+// Map a direction name from the topology file to its interned id.
+// Only called while the links are being created.
+PortDirectionId
+GarnetNetwork::getPortDirectionId(const PortDirection& direction)
+{
+    for (int i = 0; i < m_port_dirn_names.size(); i++) {
+        if (m_port_dirn_names[i] == direction)
+            return (PortDirectionId) i;
+    }
+
+    fatal_if(m_port_dirn_names.size() >= MAX_PORT_DIRNS_,
+             "Too many distinct port directions in topology (max %d)",
+             MAX_PORT_DIRNS_);
+
+    m_port_dirn_names.push_back(direction);
+    return (PortDirectionId) (m_port_dirn_names.size() - 1);
+}
+
+const std::string&
+GarnetNetwork::getPortDirectionName(PortDirectionId direction) const
+{
+    static const std::string unknown = "Unknown";
+    if (direction < 0 || direction >= m_port_dirn_names.size())
+        return unknown;
+    return m_port_dirn_names[direction];
+}
+
 void
 GarnetNetwork::regStats()
 {
@@ -321,6 +706,47 @@ GarnetNetwork::regStats()
     m_avg_packet_latency
         = m_avg_packet_network_latency + m_avg_packet_queueing_latency;
 
+    for (int i = 0; i < m_virtual_networks; i++) {
+        m_packet_network_latency_hist.push_back(new Stats::Histogram());
+        m_packet_network_latency_hist[i]
+            ->init(10)
+            .name(name() + csprintf(".packet_network_latency_hist.vnet-%i",
+                                    i))
+            .flags(Stats::nozero | Stats::pdf | Stats::oneline);
+
+        m_packet_queueing_latency_hist.push_back(new Stats::Histogram());
+        m_packet_queueing_latency_hist[i]
+            ->init(10)
+            .name(name() + csprintf(".packet_queueing_latency_hist.vnet-%i",
+                                    i))
+            .flags(Stats::nozero | Stats::pdf | Stats::oneline);
+    }
+
+    for (const char *percentile : latencyPercentileNames) {
+        Stats::Vector *dest_latency = new Stats::Vector();
+        dest_latency
+            ->init(m_nodes)
+            .name(name() + ".packet_latency_" + percentile)
+            .flags(Stats::nozero);
+        for (int i = 0; i < m_nodes; i++)
+            dest_latency->subname(i, csprintf("ni-%i", i));
+        m_packet_latency_percentiles.push_back(dest_latency);
+
+        if (m_pair_latency.empty())
+            continue;
+
+        Stats::Vector2d *pair_latency = new Stats::Vector2d();
+        pair_latency
+            ->init(m_nodes, m_nodes)
+            .name(name() + ".pair_packet_latency_" + percentile)
+            .flags(Stats::nozero);
+        for (int i = 0; i < m_nodes; i++) {
+            pair_latency->subname(i, csprintf("ni-%i", i));
+            pair_latency->ysubname(i, csprintf("ni-%i", i));
+        }
+        m_pair_latency_percentiles.push_back(pair_latency);
+    }
+
     // Flits
     m_flits_received
         .init(m_virtual_networks)
@@ -390,6 +816,11 @@ GarnetNetwork::regStats()
     m_avg_hpc.name(name() + ".average_hpc");
     m_avg_hpc = m_total_hops / m_total_smart_hops;
 
+    m_smart_hop_routers_hist
+        .init(m_smart_hpcmax + 1)
+        .name(name() + ".smart_hop_routers_hist")
+        .flags(Stats::nozero | Stats::pdf | Stats::oneline);
+
     // Links
     m_total_ext_in_link_utilization
         .name(name() + ".ext_in_link_utilization");
@@ -405,6 +836,26 @@ GarnetNetwork::regStats()
         .name(name() + ".avg_vc_load")
         .flags(Stats::pdf | Stats::total | Stats::nozero | Stats::oneline)
         ;
+
+    // Object pools
+    m_pool_allocations
+        .init(NUM_POOL_TYPES_)
+        .name(name() + ".pool_allocations")
+        .flags(Stats::total | Stats::oneline)
+        ;
+
+    m_pool_capacity
+        .init(NUM_POOL_TYPES_)
+        .name(name() + ".pool_capacity")
+        .flags(Stats::total | Stats::oneline)
+        ;
+
+    const char *pool_names[NUM_POOL_TYPES_] =
+        { "flit", "credit", "route" };
+    for (int i = 0; i < NUM_POOL_TYPES_; i++) {
+        m_pool_allocations.subname(i, pool_names[i]);
+        m_pool_capacity.subname(i, pool_names[i]);
+    }
 }
 
 void
@@ -426,6 +877,7 @@ GarnetNetwork::collateStats()
 
         m_average_link_utilization +=
             (double(activity) / time_delta);
+        m_networklinks[i]->collateStats(time_delta);
 
         vector<unsigned int> vc_load = m_networklinks[i]->getVcLoad();
         for (int j = 0; j < vc_load.size(); j++) {
@@ -437,6 +889,67 @@ GarnetNetwork::collateStats()
     for (int i = 0; i < m_routers.size(); i++) {
         m_routers[i]->collateStats();
     }
+
+    m_smart_hop_routers_hist.reset();
+    auto sample_smart_hops = [this](const vector<uint64_t>& counts) {
+        for (int routers = 0; routers < counts.size(); routers++) {
+            if (counts[routers] > 0)
+                m_smart_hop_routers_hist.sample(routers, counts[routers]);
+        }
+    };
+    sample_smart_hops(m_smart_hop_counts);
+    for (int i = 0; i < m_routers.size(); i++)
+        sample_smart_hops(m_routers[i]->get_smart_hop_counts());
+
+    m_pool_allocations[FLIT_POOL_] =
+        PooledObject<flit>::getPoolStats().allocations;
+    m_pool_allocations[CREDIT_POOL_] =
+        PooledObject<Credit>::getPoolStats().allocations;
+    m_pool_allocations[ROUTE_POOL_] =
+        PooledObject<RouteInfo>::getPoolStats().allocations;
+
+    m_pool_capacity[FLIT_POOL_] =
+        PooledObject<flit>::getPoolStats().capacity;
+    m_pool_capacity[CREDIT_POOL_] =
+        PooledObject<Credit>::getPoolStats().capacity;
+    m_pool_capacity[ROUTE_POOL_] =
+        PooledObject<RouteInfo>::getPoolStats().capacity;
+
+    for (int i = 0; i < m_packet_latency_percentiles.size(); i++) {
+        const double percentile = latencyPercentiles[i];
+        for (int dst = 0; dst < m_nodes; dst++) {
+            (*m_packet_latency_percentiles[i])[dst] =
+                m_dest_latency[dst].percentile(percentile);
+        }
+
+        if (m_pair_latency.empty())
+            continue;
+
+        for (int src = 0; src < m_nodes; src++) {
+            for (int dst = 0; dst < m_nodes; dst++) {
+                (*m_pair_latency_percentiles[i])[src][dst] =
+                    m_pair_latency[src * m_nodes + dst].percentile(
+                        percentile);
+            }
+        }
+    }
+}
+
+void
+GarnetNetwork::resetStats()
+{
+    Network::resetStats();
+
+    PooledObject<flit>::resetPoolStats();
+    PooledObject<Credit>::resetPoolStats();
+    PooledObject<RouteInfo>::resetPoolStats();
+
+    for (int i = 0; i < m_dest_latency.size(); i++)
+        m_dest_latency[i].reset();
+    for (int i = 0; i < m_pair_latency.size(); i++)
+        m_pair_latency[i].reset();
+
+    m_smart_hop_counts.clear();
 }
 
 void
@@ -473,68 +986,68 @@ GarnetNetwork::functionalWrite(Packet *pkt)
 
 
 // SMART NoC
-void
-GarnetNetwork::sendSSR(int src, PortDirection outport_dirn, int req_hops,
-                       SSR* t_ssr)
+// SSR paths follow the links recorded by makeInternalLink() and the
+// routing decision of every router along the way, so they work on
+// meshes, tori (wrap-around links) and any other topology.
+//
+// SMART_1D: the SSRs stop at the first router where the flit turns.
+// SMART_2D: they follow the flit through turns as well.
+//
+// An SSR is sent to every router (at most max_hops) the flit can reach
+// from src through outport_dirn; the last one gets bypass_req = false.
+// Returns the number of routers the SSRs were sent to.
+int
+GarnetNetwork::sendSSR(int src, PortDirectionId outport_dirn,
+                       RouteInfo* route, int max_hops,
+                       const SSR& t_ssr)
 {
-    //int src_x = src % m_num_cols;
-    int src_y = src / m_num_cols;
+    if (outport_dirn == LOCAL_ || src >= m_ssr_links.size())
+        return 0;
 
-    // Send SSR up to req_hops - 1 with bypass_req = true;
-    for (int hops = 1; hops <= req_hops; hops++) {
+    int hops = 0;
+    int router = src;
+    PortDirectionId dirn = outport_dirn;
 
-        bool bypass_req = true;
-        if (hops == req_hops)
-            bypass_req = false;
+    while (hops < max_hops) {
+        const SSRLink& link = m_ssr_links[router][dirn];
+        if (link.dest == -1 || link.dest == src)
+            break;
 
-        if (outport_dirn == "East") {
-            int dst = src + hops;
-            if (dst / m_num_cols == src_y) {
-                // valid dst on same row
+        hops++;
+        router = link.dest;
 
-                insertSSR(dst, "West", hops, bypass_req, t_ssr);
-            }
-        } else if (outport_dirn == "West") {
-            int dst = src - hops;
-            if (dst > 0 && dst / m_num_cols == src_y) {
-                // valid dst on same row
+        // Where the flit leaves this router
+        PortDirectionId next_dirn = UNKNOWN_DIRN_;
+        if (router != route->dest_router)
+            next_dirn = m_routers[router]->peek_outport_dirn(*route,
+                                                             link.inport_dirn);
 
-                insertSSR(dst, "East", hops, bypass_req, t_ssr);
-            }
-        } else if (outport_dirn == "North") {
-            int dst = src + m_num_cols * hops;
-            if (dst / m_num_cols < m_num_rows) {
-                // valid dst
+        bool stop = (hops == max_hops ||
+                     next_dirn == UNKNOWN_DIRN_ ||
+                     (next_dirn != dirn && !m_smart_2d));
 
-                insertSSR(dst, "South", hops, bypass_req, t_ssr);
-            }
-        } else if (outport_dirn == "South") {
-            int dst = src - m_num_cols * hops;
-            if (dst / m_num_cols > 0) {
-                // valid dst
+        insertSSR(router, link.inport_dirn, hops, !stop,
+                  stop ? dirn : next_dirn, t_ssr);
 
-                insertSSR(dst, "North", hops, bypass_req, t_ssr);
-            }
-        } else {
-            assert(0);
-        }
+        if (stop)
+            break;
+
+        dirn = next_dirn;
     }
 
-    // insertSSR makes a copy of the SSR for every dest
-    delete t_ssr;
+    return hops;
 }
 
 void
-GarnetNetwork::insertSSR(int dst, PortDirection inport_dirn,
-                         int src_hops, bool bypass_req, SSR* orig_ssr)
+GarnetNetwork::insertSSR(int dst, PortDirectionId inport_dirn,
+                         int src_hops, bool bypass_req,
+                         PortDirectionId outport_dirn, const SSR& orig_ssr)
 {
- //   DPRINTF(FlitOrder, "[GN]SSR %s is sent\n", *orig_ssr->get_ref_flit());
-    SSR *t_ssr = new SSR(orig_ssr->get_vnet(),
-                         src_hops,
-                         bypass_req,
-                         orig_ssr->get_outport_dirn(),
-                         orig_ssr->get_ref_flit(),
-                         orig_ssr->get_time());
+    // Every dest gets its own copy of the SSR
+    SSR t_ssr = orig_ssr;
+    t_ssr.m_src_hops = src_hops;
+    t_ssr.set_bypass_req(bypass_req);
+    t_ssr.set_outport_dirn(outport_dirn);
 
     m_routers[dst]->insertSSR(inport_dirn, t_ssr);
 }
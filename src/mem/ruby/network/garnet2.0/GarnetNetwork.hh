@@ -35,11 +35,13 @@
 #define __MEM_RUBY_NETWORK_GARNET2_0_GARNETNETWORK_HH__
 
 #include <iostream>
+#include <mutex>
 #include <vector>
 
 #include "mem/ruby/network/Network.hh"
 #include "mem/ruby/network/fault_model/FaultModel.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
+#include "mem/ruby/network/garnet2.0/LatencyPercentile.hh"
 #include "params/GarnetNetwork.hh"
 
 class FaultModel;
@@ -49,6 +51,8 @@ class NetDest;
 class NetworkLink;
 class CreditLink;
 class SSR;
+class OutputStream;
+class ProtoOutputStream;
 
 class GarnetNetwork : public Network
 {
@@ -75,6 +79,8 @@ class GarnetNetwork : public Network
     bool isSMART() const { return m_enable_smart; }
     int getHPCmax() const { return m_smart_hpcmax; }
     bool isSMARTdestBypass() const { return m_smart_dest_bypass; }
+    bool isSMART2D() const { return m_smart_2d; }
+    SMARTPriority getSMARTPriority() const { return m_smart_priority; }
 
     bool isFaultModelEnabled() const { return m_enable_fault_model; }
     FaultModel* fault_model;
@@ -91,6 +97,10 @@ class GarnetNetwork : public Network
     int getNumRouters();
     int get_router_id(int ni);
 
+    // Interned port directions
+    PortDirectionId getPortDirectionId(const PortDirection& direction);
+    const std::string& getPortDirectionName(PortDirectionId direction) const;
+
 
     // Methods used by Topology to setup the network
     void makeExtOutLink(SwitchID src, NodeID dest, BasicLink* link,
@@ -109,6 +119,7 @@ class GarnetNetwork : public Network
     // Stats
     void collateStats();
     void regStats();
+    void resetStats();
     void print(std::ostream& out) const;
 
     // increment counters
@@ -142,6 +153,19 @@ class GarnetNetwork : public Network
         m_flit_queueing_latency[vnet] += latency;
     }
 
+    void
+    sample_packet_latency(int vnet, int src_ni, int dest_ni,
+                          Cycles network_delay, Cycles queueing_delay)
+    {
+        m_packet_network_latency_hist[vnet]->sample(network_delay);
+        m_packet_queueing_latency_hist[vnet]->sample(queueing_delay);
+
+        Cycles latency = network_delay + queueing_delay;
+        m_dest_latency[dest_ni].sample(latency);
+        if (!m_pair_latency.empty())
+            m_pair_latency[src_ni * m_nodes + dest_ni].sample(latency);
+    }
+
     void
     increment_total_hops(int hops)
     {
@@ -154,11 +178,59 @@ class GarnetNetwork : public Network
         m_total_smart_hops += smart_hops;
     }
 
+    // Routers crossed in one smart hop (i.e., in one cycle).
+    // Called by the NIs; routers count their own (see Router.hh) as
+    // they may run on other threads, and collateStats adds them up.
+    void
+    sample_smart_hop(int routers)
+    {
+        if (routers <= 0)
+            return;
+        if (routers >= m_smart_hop_counts.size())
+            m_smart_hop_counts.resize(routers + 1, 0);
+        m_smart_hop_counts[routers]++;
+    }
+
+    // Packets delivered to the NIs of each router, and when the last
+    // one was. Used by network trace record and replay.
+    void
+    increment_delivered_packets(int router)
+    {
+        m_packets_delivered[router]++;
+        m_last_delivery[router] = curTick();
+    }
+    uint64_t get_delivered_packets(int router) const
+    { return m_packets_delivered[router]; }
+    Tick get_last_delivery(int router) const
+    { return m_last_delivery[router]; }
+
+    // Network trace (see src/proto/network_trace.proto)
+    bool isRecordingTrace() const { return m_trace_stream != nullptr; }
+    void recordTrace(int src_ni, int dest_ni, int vnet, int num_flits,
+                     Tick ready_time);
+
+    // Utilization time series. Routers and links sample themselves
+    // every m_util_period ticks, on their own event queues, and the
+    // rows are written under m_util_mutex.
+    bool isSamplingUtilization() const { return m_util_period > 0; }
+    Tick
+    nextUtilizationSample() const
+    {
+        return (curTick() / m_util_period + 1) * m_util_period;
+    }
+    void recordRouterUtilization(int router, double vc_occupancy,
+                                 double sa_requests, double sa_grants,
+                                 uint64_t smart_tries,
+                                 uint64_t smart_bypasses);
+    void recordLinkUtilization(const NetworkLink *link, uint64_t flits,
+                               Cycles window);
+
     // SMART NoC
-    void sendSSR(int src, PortDirection outport_dirn,
-                 int req_hops, SSR* t_ssr);
-    void insertSSR(int dst, PortDirection inport_dirn, int src_hops,
-                    bool bypass_req, SSR* orig_ssr);
+    int sendSSR(int src, PortDirectionId outport_dirn,
+                RouteInfo* route, int max_hops, const SSR& t_ssr);
+    void insertSSR(int dst, PortDirectionId inport_dirn, int src_hops,
+                   bool bypass_req, PortDirectionId outport_dirn,
+                   const SSR& orig_ssr);
 
   protected:
     // Configuration
@@ -172,6 +244,8 @@ class GarnetNetwork : public Network
     bool m_enable_smart;
     int m_smart_hpcmax;
     bool m_smart_dest_bypass;
+    bool m_smart_2d;
+    SMARTPriority m_smart_priority;
     bool m_enable_fault_model;
 
     // Statistical variables
@@ -186,6 +260,15 @@ class GarnetNetwork : public Network
     Stats::Formula m_avg_packet_queueing_latency;
     Stats::Formula m_avg_packet_latency;
 
+    // Latency distributions per vnet
+    std::vector<Stats::Histogram *> m_packet_network_latency_hist;
+    std::vector<Stats::Histogram *> m_packet_queueing_latency_hist;
+
+    // Packet latency (network + queueing) percentiles per destination
+    // NI, and per source/destination NI pair with pair_latency_stats
+    std::vector<Stats::Vector *> m_packet_latency_percentiles;
+    std::vector<Stats::Vector2d *> m_pair_latency_percentiles;
+
     Stats::Vector m_flits_received;
     Stats::Vector m_flits_injected;
     Stats::Vector m_flit_network_latency;
@@ -209,8 +292,22 @@ class GarnetNetwork : public Network
     Stats::Scalar  m_total_smart_hops;
     Stats::Formula m_avg_smart_hops;
     Stats::Formula m_avg_hpc;
+    Stats::Histogram m_smart_hop_routers_hist;
+
+    // Object pools, process-wide (see ObjectPool.hh)
+    Stats::Vector m_pool_allocations;
+    Stats::Vector m_pool_capacity;
 
   private:
+    void setCrossQueue(NetworkLink *link, EventManager *consumer);
+    void closeTraceStream();
+    void closeUtilizationStreams();
+
+    // End of simulation report (see report_file in GarnetNetwork.py)
+    void writeReport();
+    void printHeatmap(std::ostream& out, const std::string& title,
+                      const std::vector<double>& values) const;
+
     GarnetNetwork(const GarnetNetwork& obj);
     GarnetNetwork& operator=(const GarnetNetwork& obj);
 
@@ -219,6 +316,43 @@ class GarnetNetwork : public Network
     std::vector<NetworkLink *> m_networklinks; // All flit links in the network
     std::vector<CreditLink *> m_creditlinks; // All credit links in the network
     std::vector<NetworkInterface *> m_nis;   // All NI's in Network
+
+    // Smart hops ended at an NI, by number of routers crossed
+    std::vector<uint64_t> m_smart_hop_counts;
+
+    // Packet latency samples per dest NI, and per
+    // (src NI * m_nodes + dest NI) with pair_latency_stats
+    std::vector<LatencyPercentile> m_dest_latency;
+    std::vector<LatencyPercentile> m_pair_latency;
+
+    // Indexed by router
+    std::vector<uint64_t> m_packets_delivered;
+    std::vector<Tick> m_last_delivery;
+
+    std::string m_trace_file;
+    ProtoOutputStream *m_trace_stream;
+
+    std::string m_util_file;
+    Cycles m_util_interval;
+    Tick m_util_period;
+    OutputStream *m_router_util_stream;
+    OutputStream *m_link_util_stream;
+    std::mutex m_util_mutex;
+
+    std::string m_report_file;
+
+    // Name of every interned port direction, indexed by PortDirectionId
+    std::vector<PortDirection> m_port_dirn_names;
+
+    // SMART NoC: router-to-router links, recorded as they are created.
+    // m_ssr_links[src][outport_dirn] is the router and inport that
+    // outport connects to (dest = -1 if there is no such link).
+    struct SSRLink
+    {
+        int dest;
+        PortDirectionId inport_dirn;
+    };
+    std::vector<std::vector<SSRLink> > m_ssr_links;
 };
 
 inline std::ostream&
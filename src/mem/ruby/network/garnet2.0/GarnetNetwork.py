@@ -43,13 +43,30 @@ class GarnetNetwork(RubyNetwork):
     buffers_per_data_vc = Param.UInt32(4, "buffers per data virtual channel");
     buffers_per_ctrl_vc = Param.UInt32(1, "buffers per ctrl virtual channel");
     routing_algorithm = Param.Int(0,
-        "0: Weight-based Table, 1: XY, 2: Custom");
-    enable_smart = Param.Bool(False,
-            "enable SMART (only 1D supported currently)");
+        "0: Weight-based Table, 1: XY, 2: Custom, "
+        "3: West-first adaptive, 4: Odd-even adaptive");
+    enable_smart = Param.Bool(False, "enable SMART");
     smart_hpcmax = Param.Int(4, "HPC_max for SMART");
     smart_dest_bypass = Param.Bool(False, "enable SMART destination bypass");
+    smart_2d = Param.Bool(False,
+            "SMART_2D: bypass through turns (default SMART_1D)");
+    smart_priority = Param.Int(0,
+        "SSR priority among bypassing flits (local flits always win). "
+        "0: closest source first, 1: farthest source first");
     enable_fault_model = Param.Bool(False, "enable network fault model");
     fault_model = Param.FaultModel(NULL, "network fault model");
+    trace_file = Param.String("", "record a network trace to this file "
+        "(relative to the output directory; .gz to compress)")
+    util_file = Param.String("", "sample router and link utilization to "
+        "<util_file>.routers.csv and <util_file>.links.csv (relative to "
+        "the output directory; .gz to compress)")
+    util_interval = Param.Cycles(10000, "utilization sampling interval")
+    report_file = Param.String("", "write router heatmaps and the busiest "
+        "links to this file (relative to the output directory) at the end "
+        "of simulation")
+    pair_latency_stats = Param.Bool(False, "report packet latency "
+        "percentiles per source/destination NI pair, besides the ones per "
+        "destination NI")
     garnet_deadlock_threshold = Param.UInt32(50000,
                               "network-level deadlock threshold")
 
@@ -44,7 +44,7 @@
 using namespace std;
 using m5::stl_helpers::deletePointers;
 
-InputUnit::InputUnit(int id, PortDirection direction, Router *router)
+InputUnit::InputUnit(int id, PortDirectionId direction, Router *router)
             : Consumer(router)
 {
     m_id = id;
@@ -68,6 +68,7 @@ InputUnit::InputUnit(int id, PortDirection direction, Router *router)
     }
     currentPacket = -1;
     lastflit = NULL;
+    m_buffered_flits = 0;
 }
 
 InputUnit::~InputUnit()
@@ -89,8 +90,7 @@ InputUnit::~InputUnit()
 void
 InputUnit::wakeup()
 {
-    // dangling pointer
-    flit *t_flit = new flit();
+    flit *t_flit;
     DPRINTF(VC, "[IU] Calling wakeup %#x\n", this);
     if (m_in_link->isReady(m_router->curCycle())) {
 
@@ -108,7 +108,8 @@ InputUnit::wakeup()
         //t_flit->increment_hops(); // for stats
 
     DPRINTF(RubyNetwork, "Router %d Inport %s received flit %s at link %d\n",
-        m_router->get_id(), m_direction, *t_flit, m_in_link->get_id());
+        m_router->get_id(), m_router->getPortDirectionName(m_direction),
+        *t_flit, m_in_link->get_id());
 
         DPRINTF(FlitOrder, "[IU] flit %d-%d entering port %d at router %d\n",
                 t_flit->get_pid(), t_flit->get_id(),
@@ -195,6 +196,8 @@ InputUnit::wakeup()
 
         // Buffer the flit
         m_vcs[vc]->insertFlit(t_flit);
+        m_buffered_flits++;
+        m_router->update_buffered_flits(1);
 
         int vnet = vc/m_vc_per_vnet;
         // number of writes same as reads
@@ -271,78 +274,87 @@ InputUnit::try_smart_bypass(flit *t_flit)
     // Check if router is setup for SMART bypass this cycle
     DPRINTF(RubyNetwork, "[InputUnit] Router %d Inport %s"
             " trying to bypass flit %s\n",
-                 m_router->get_id(), m_direction, *t_flit);
+                 m_router->get_id(),
+                 m_router->getPortDirectionName(m_direction), *t_flit);
    DPRINTF(FlitOrder, "IU flit %d-%d arrived at IU::try_smart_bypass"
            " at Router %d\n",
            t_flit->get_pid(),
            t_flit->get_id(),
            m_router->get_id());
+
+    m_router->count_smart_try();
+
     // Check SSR Grant for this cycle
-    if (ssr_grant.empty()){
+    Cycles curTime = m_router->curCycle();
+    SSR& t_ssr = m_ssr_grant[curTime % SSR_SLOTS_];
+
+    if (!t_ssr.is_valid(curTime)) {
         DPRINTF(FlitOrder,"IU SSR grant is empty for flit %d-%d\n",
                 t_flit->get_pid(), t_flit->get_id());
-    }
-    while (!ssr_grant.empty()) {
-        SSR *t_ssr = ssr_grant.top();
-        /*if (t_ssr->get_time() < m_router->curCycle()) {
-            ssr_grant.pop();
-            delete t_ssr;
-        } else */
-        if (t_ssr->get_time() <= m_router->curCycle()) {
-            if (t_ssr->get_ref_flit() != t_flit) {
-                // (i) this flit lost arbitration to a local flit, or
-                // (ii) wanted to stop, and hence its SSR was not sent to 
-                //      this router, and some other SSR won.
-
-                DPRINTF(FlitOrder, "IU flit %d-%d lost"
-                        " arbitration at Router %d\n",
-                        t_flit->get_pid(),
-                        t_flit->get_id(),
-                        m_router->get_id());
+        DPRINTF(FlitOrder, "IU flit %d-%d failed at try_smart_bypass"
+                " at Router %d\n",
+                t_flit->get_pid(),
+                t_flit->get_id(),
+                m_router->get_id());
 
-                return false;
-            } else {
+        return false;
+    }
 
-                DPRINTF(FlitOrder, "IU flit %d-%d trying try_smart_bypass \n",
-                        t_flit->get_pid(), t_flit->get_id());
+    if (!t_ssr.refers_to(t_flit)) {
+        // (i) this flit lost arbitration to a local flit, or
+        // (ii) wanted to stop, and hence its SSR was not sent to
+        //      this router, and some other SSR won.
 
-                // SSR for this flit won arbitration last cycle
-                // and wants to bypass this router
-                assert(t_ssr->get_bypass_req());
-                bool smart_bypass =
-                    m_router->try_smart_bypass(m_id,
-                                               t_ssr->get_outport_dirn(),
-                                               t_flit);
+        DPRINTF(FlitOrder, "IU flit %d-%d lost"
+                " arbitration at Router %d\n",
+                t_flit->get_pid(),
+                t_flit->get_id(),
+                m_router->get_id());
 
-                ssr_grant.pop();
-                delete t_ssr;
-                return smart_bypass;
-            }
-        } else {
-            break;
-        }
+        return false;
     }
-    DPRINTF(FlitOrder, "IU flit %d-%d failed at try_smart_bypass"
-            " at Router %d\n",
-            t_flit->get_pid(),
-            t_flit->get_id(),
-            m_router->get_id());
 
-    return false;
-}
+    DPRINTF(FlitOrder, "IU flit %d-%d trying try_smart_bypass \n",
+            t_flit->get_pid(), t_flit->get_id());
 
-void    
-InputUnit::grantSSR(SSR *t_ssr)
-{           
-    DPRINTF(RubyNetwork, "Router %d Inport %s granted SSR"
-            "for flit %d from src_hops %d for bypass = %d for Outport %s\n",
-            m_router->get_id(), m_direction, *(t_ssr->get_ref_flit()),
-            t_ssr->get_src_hops(),
-            t_ssr->get_bypass_req(), t_ssr->get_outport_dirn());
+    // SSR for this flit won arbitration last cycle
+    // and wants to bypass this router
+    assert(t_ssr.get_bypass_req());
+    t_ssr.invalidate();
 
+    bool bypassed = m_router->try_smart_bypass(m_id,
+                                               t_ssr.get_outport_dirn(),
+                                               t_flit);
+    if (bypassed)
+        m_router->count_smart_bypass();
 
-    // Update valid time to next cycle
-    t_ssr->set_time(m_router->curCycle() + Cycles(1));        
-    ssr_grant.push(t_ssr);
+    return bypassed;
 }
 
+// SSR won SA-G at one of the outports
+// The flit it refers to may bypass this inport next cycle
+void
+InputUnit::grantSSR(const SSR& t_ssr)
+{
+    // Update valid time to next cycle
+    SSR grant = t_ssr;
+    grant.set_time(m_router->curCycle() + Cycles(1));
+
+    DPRINTF(RubyNetwork, "Router %d Inport %s granted SSR"
+            "for flit %d from src_hops %d for bypass = %d for Outport %s\n",
+            m_router->get_id(), m_router->getPortDirectionName(m_direction),
+            grant.m_ref_pid, grant.get_src_hops(),
+            grant.get_bypass_req(),
+            m_router->getPortDirectionName(grant.get_outport_dirn()));
+
+    // A local SSR (0 hops) only has to win the outport;
+    // its flit is already buffered here and will not arrive on the link
+    if (grant.get_src_hops() == 0)
+        return;
+
+    SSR& slot = m_ssr_grant[grant.get_time() % SSR_SLOTS_];
+    SMARTPriority prio = m_router->get_net_ptr()->getSMARTPriority();
+    if (!slot.is_valid(grant.get_time()) ||
+        grant.has_priority_over(slot, prio))
+        slot = grant;
+}
@@ -36,7 +36,6 @@
 
 #include <iostream>
 #include <vector>
-#include <queue>
 
 #include "mem/ruby/common/Consumer.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
@@ -51,7 +50,7 @@
 class InputUnit : public Consumer
 {
   public:
-    InputUnit(int id, PortDirection direction, Router *router);
+    InputUnit(int id, PortDirectionId direction, Router *router);
     ~InputUnit();
 
     void set_id(int i){ m_id = i;}
@@ -60,7 +59,7 @@ class InputUnit : public Consumer
     void wakeup();
     void print(std::ostream& out) const {};
 
-    inline PortDirection get_direction() { return m_direction; }
+    inline PortDirectionId get_direction() { return m_direction; }
 
     inline bool
     is_vc_idle(int vc)
@@ -122,9 +121,18 @@ class InputUnit : public Consumer
     inline flit*
     getTopFlit(int vc)
     {
+        m_buffered_flits--;
+        m_router->update_buffered_flits(-1);
         return m_vcs[vc]->getTopFlit();
     }
 
+    // Any flit waiting in one of the VCs of this inport
+    inline bool
+    has_buffered_flits()
+    {
+        return m_buffered_flits > 0;
+    }
+
     inline bool
     need_stage(int vc, flit_stage stage, Cycles time)
     {
@@ -164,12 +172,12 @@ class InputUnit : public Consumer
     void resetStats();
 
     // SMART NoC
-    void grantSSR(SSR *t_ssr);
+    void grantSSR(const SSR& t_ssr);
     bool try_smart_bypass(flit *t_flit);
 
   private:
     int m_id;
-    PortDirection m_direction;
+    PortDirectionId m_direction;
     int m_num_vcs;
     int m_vc_per_vnet;
 
@@ -182,24 +190,15 @@ class InputUnit : public Consumer
 
     // Input Virtual channels
     std::vector<VirtualChannel *> m_vcs;
+    int m_buffered_flits;
 
     // Statistical variables
     std::vector<double> m_num_buffer_writes;
     std::vector<double> m_num_buffer_reads;
 
     // SMART
-    struct SSR_time
-    {
-        bool operator()(const SSR *lhs, const SSR *rhs) const
-        {
-                return lhs->m_time >= rhs->m_time;
-        }
-    };
-
-
-    // Moved to Output Unit
-//    std::priority_queue<SSR*, std::vector<SSR*>, SSR_prio_local> ssr_reqs;
-    std::priority_queue<SSR*, std::vector<SSR*>, SSR_time> ssr_grant;
+    // SSR granted to a flit arriving at this inport, per cycle
+    SSR m_ssr_grant[SSR_SLOTS_];
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET2_0_INPUTUNIT_HH__
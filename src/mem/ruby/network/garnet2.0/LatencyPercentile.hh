@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __MEM_RUBY_NETWORK_GARNET2_0_LATENCYPERCENTILE_HH__
+#define __MEM_RUBY_NETWORK_GARNET2_0_LATENCYPERCENTILE_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "base/intmath.hh"
+
+// Bucketed latency counts for percentile (p50, p99, ...) queries.
+// Latencies below linearLimit get a bucket each. Above that, every
+// power of two is split into subBuckets buckets, so a reported
+// percentile is at most 1/subBuckets above the true value while the
+// number of buckets only grows with the log of the largest latency.
+// Buckets are allocated as they are first needed.
+
+class LatencyPercentile
+{
+  public:
+    LatencyPercentile() : m_samples(0) {}
+
+    void
+    sample(uint64_t latency)
+    {
+        int bucket = bucketOf(latency);
+        if (bucket >= m_buckets.size())
+            m_buckets.resize(bucket + 1, 0);
+        m_buckets[bucket]++;
+        m_samples++;
+    }
+
+    uint64_t samples() const { return m_samples; }
+
+    // Smallest latency that at least a fraction p of the samples do
+    // not exceed (rounded up to the top of its bucket)
+    uint64_t
+    percentile(double p) const
+    {
+        if (m_samples == 0)
+            return 0;
+
+        uint64_t target = (uint64_t)(p * m_samples);
+        if (target < p * m_samples || target == 0)
+            target++;
+
+        uint64_t count = 0;
+        for (int bucket = 0; bucket < m_buckets.size(); bucket++) {
+            count += m_buckets[bucket];
+            if (count >= target)
+                return bucketTop(bucket);
+        }
+        return bucketTop(m_buckets.size() - 1);
+    }
+
+    void
+    reset()
+    {
+        m_buckets.clear();
+        m_samples = 0;
+    }
+
+  private:
+    static const int subBucketBits = 4;
+    static const int subBuckets = 1 << subBucketBits;
+    static const int linearBits = 6;
+    static const uint64_t linearLimit = 1 << linearBits;
+
+    static int
+    bucketOf(uint64_t latency)
+    {
+        if (latency < linearLimit)
+            return latency;
+
+        int msb = floorLog2(latency);
+        int shift = msb - subBucketBits;
+        int sub = (latency >> shift) - subBuckets;
+        return linearLimit + (msb - linearBits) * subBuckets + sub;
+    }
+
+    static uint64_t
+    bucketTop(int bucket)
+    {
+        if (bucket < linearLimit)
+            return bucket;
+
+        int msb = linearBits + (bucket - linearLimit) / subBuckets;
+        int shift = msb - subBucketBits;
+        uint64_t sub = (bucket - linearLimit) % subBuckets;
+        return ((subBuckets + sub + 1) << shift) - 1;
+    }
+
+    std::vector<uint64_t> m_buckets;
+    uint64_t m_samples;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET2_0_LATENCYPERCENTILE_HH__
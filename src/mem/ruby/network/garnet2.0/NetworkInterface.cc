@@ -163,14 +163,19 @@ NetworkInterface::incrementStats(flit *t_flit)
 
     if (t_flit->get_type() == TAIL_ || t_flit->get_type() == HEAD_TAIL_) {
         m_net_ptr->increment_received_packets(vnet);
+        m_net_ptr->increment_delivered_packets(m_router_id);
         m_net_ptr->increment_packet_network_latency(network_delay, vnet);
         m_net_ptr->increment_packet_queueing_latency(queueing_delay, vnet);
+        m_net_ptr->sample_packet_latency(vnet, t_flit->get_route()->src_ni,
+                                         t_flit->get_route()->dest_ni,
+                                         network_delay, queueing_delay);
     }
 
     // Hops
     m_net_ptr->increment_total_hops(t_flit->get_route()->hops_traversed);
     m_net_ptr->increment_total_smart_hops(
             t_flit->get_route()->smart_hops_traversed);
+    m_net_ptr->sample_smart_hop(t_flit->end_smart_hop());
 }
 
 /*
@@ -236,9 +241,11 @@ NetworkInterface::wakeup()
                 DPRINTF(SMART, "[NI] Credit Sent tail fleet\n");
 
                 // Update stats and delete flit pointer
+                // (the tail flit is the last user of the packet's route)
                 incrementStats(t_flit);
                 DPRINTF(VC, "flit %s is deleted at Router %d\n",
                         *t_flit, m_router_id);
+                delete t_flit->get_route();
                 delete t_flit;
             } else {
                 // No space available- Place tail flit in stall queue and set
@@ -330,6 +337,7 @@ NetworkInterface::checkStallQueue()
                 incrementStats(stallFlit);
 
                 // Flit can now safely be deleted and removed from stall queue
+                delete stallFlit->get_route();
                 delete stallFlit;
                 m_stall_queue.erase(stallIter);
                 m_stall_count[vnet]--;
@@ -417,6 +425,11 @@ NetworkInterface::flitisizeMessage(MsgPtr msg_ptr, int vnet)
         route->smart_hops_traversed = 0;
 
         m_net_ptr->increment_injected_packets(vnet);
+        if (m_net_ptr->isRecordingTrace()) {
+            m_net_ptr->recordTrace(m_id, destID, vnet, num_flits,
+                                   msg_ptr->getLastEnqueueTime());
+        }
+
         for (int i = 0; i < num_flits; i++) {
             m_net_ptr->increment_injected_flits(vnet);
             DPRINTF(SMART, "[SA] At creation time VC %d\n", vc);
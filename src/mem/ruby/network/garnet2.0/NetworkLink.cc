@@ -33,9 +33,11 @@
 
 #include "mem/ruby/network/garnet2.0/NetworkLink.hh"
 
+#include "base/logging.hh"
 #include "debug/SMART.hh"
 #include "debug/VC.hh"
 #include "mem/ruby/network/garnet2.0/CreditLink.hh"
+#include "mem/ruby/network/garnet2.0/GarnetNetwork.hh"
 #include "mem/ruby/network/garnet2.0/InputUnit.hh"
 
 NetworkLink::NetworkLink(const Params *p)
@@ -43,8 +45,12 @@ NetworkLink::NetworkLink(const Params *p)
       m_type(NUM_LINK_TYPES_),
       m_latency(p->link_latency),
       linkBuffer(new flitBuffer()), link_consumer(nullptr),
-      link_srcQueue(nullptr), m_link_utilized(0),
-      m_vc_load(p->vcs_per_vnet * p->virt_nets)
+      link_srcQueue(nullptr), m_cross_queue(false), m_link_utilized(0),
+      m_vc_load(p->vcs_per_vnet * p->virt_nets), m_net_ptr(nullptr),
+      m_src(-1), m_dest(-1),
+      m_util_event([this]{ sampleUtilization(); },
+                   "NetworkLink utilization sample"),
+      m_sample_util(false), m_util_last_sample(0), m_util_flits(0)
 {
 }
 
@@ -72,6 +78,20 @@ NetworkLink::setSourceQueue(flitBuffer *srcQueue)
     link_srcQueue = srcQueue;
 }
 
+// The link latency is the lookahead between the two event queues
+void
+NetworkLink::setCrossQueue(bool cross_queue)
+{
+    m_cross_queue = cross_queue;
+    if (!m_cross_queue)
+        return;
+
+    fatal_if(simQuantum == 0 || simQuantum > cyclesToTicks(m_latency),
+             "%s connects two event queues, so the simulation quantum "
+             "(%d ticks) must be non-zero and at most its latency "
+             "(%d ticks)\n", name(), simQuantum, cyclesToTicks(m_latency));
+}
+
 void
 NetworkLink::wakeup()
 {
@@ -82,6 +102,11 @@ NetworkLink::wakeup()
         m_link_utilized++;
         m_vc_load[t_flit->get_vc()]++;
 
+        // Sampling stops while the link is idle or drained, and
+        // restarts with the next flit
+        if (m_sample_util && !m_util_event.scheduled())
+            schedule(m_util_event, m_net_ptr->nextUtilizationSample());
+
         bool router_bypass = false;
         if (m_type == INT_) {
 
@@ -104,7 +129,10 @@ NetworkLink::wakeup()
             // SMART where flit has to be buffered at next router 
             // because it is turning/dest router, or SSR lost
             t_flit->set_time(curCycle() + m_latency);
-            linkBuffer->insert(t_flit);
+            {
+                BufferLock lock(this);
+                linkBuffer->insert(t_flit);
+            }
             link_consumer->scheduleEventAbsolute(clockEdge(m_latency));
         }
 
@@ -123,6 +151,72 @@ NetworkLink::wakeup()
     assert(!link_srcQueue->isReady(curCycle()));
 }
 
+void
+NetworkLink::startup()
+{
+    ClockedObject::startup();
+
+    // Only flit links are registered with the network
+    m_sample_util = m_net_ptr && m_net_ptr->isSamplingUtilization();
+    if (m_sample_util) {
+        m_util_last_sample = curTick();
+        schedule(m_util_event, m_net_ptr->nextUtilizationSample());
+    }
+}
+
+void
+NetworkLink::sampleUtilization()
+{
+    Cycles window = ticksToCycles(curTick() - m_util_last_sample);
+    m_net_ptr->recordLinkUtilization(this, m_link_utilized - m_util_flits,
+                                     window);
+
+    // Stop after a window without flits, so that an idle network does
+    // not keep the simulation running
+    bool active = m_link_utilized != m_util_flits;
+
+    m_util_last_sample = curTick();
+    m_util_flits = m_link_utilized;
+    if (active)
+        schedule(m_util_event, m_net_ptr->nextUtilizationSample());
+}
+
+DrainState
+NetworkLink::drain()
+{
+    if (m_util_event.scheduled())
+        deschedule(m_util_event);
+    return DrainState::Drained;
+}
+
+// Only flit links are registered with the network (see
+// GarnetNetwork::init); credit links get no stats of their own.
+void
+NetworkLink::regStats()
+{
+    ClockedObject::regStats();
+
+    if (!m_net_ptr)
+        return;
+
+    m_flits
+        .name(name() + ".flits")
+        .desc("flits that traversed this link")
+        ;
+
+    m_utilization
+        .name(name() + ".utilization")
+        .desc("flits per cycle")
+        ;
+}
+
+void
+NetworkLink::collateStats(double time_delta)
+{
+    m_flits = m_link_utilized;
+    m_utilization = time_delta > 0 ? m_link_utilized / time_delta : 0;
+}
+
 void
 NetworkLink::resetStats()
 {
@@ -131,6 +225,7 @@ NetworkLink::resetStats()
     }
 
     m_link_utilized = 0;
+    m_util_flits = 0;
 }
 
 NetworkLink *
@@ -37,6 +37,9 @@
 #include <iostream>
 #include <vector>
 
+#include <mutex>
+
+#include "base/statistics.hh"
 #include "mem/ruby/common/Consumer.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
 #include "mem/ruby/network/garnet2.0/flitBuffer.hh"
@@ -57,7 +60,13 @@ class NetworkLink : public ClockedObject, public Consumer
     void setLinkConsumerInport(InputUnit *inport);
     void setSourceQueue(flitBuffer *srcQueue);
     void setType(link_type type) { m_type = type; }
-    link_type getType() { return m_type; }
+    void setCrossQueue(bool cross_queue);
+    void init_net_ptr(GarnetNetwork *net_ptr) { m_net_ptr = net_ptr; }
+    link_type getType() const { return m_type; }
+    // Routers (or NIs, on external links) at the two ends
+    void setEnds(int src, int dest) { m_src = src; m_dest = dest; }
+    int get_src() const { return m_src; }
+    int get_dest() const { return m_dest; }
     void print(std::ostream& out) const {}
     int get_id() const { return m_id; }
     void wakeup();
@@ -66,15 +75,47 @@ class NetworkLink : public ClockedObject, public Consumer
     const std::vector<unsigned int> & getVcLoad() const { return m_vc_load; }
 
     inline bool isReady(Cycles curTime)
-    { return linkBuffer->isReady(curTime); }
-
-    inline flit* peekLink()       { return linkBuffer->peekTopFlit(); }
-    inline flit* consumeLink()    { return linkBuffer->getTopFlit(); }
+    {
+        BufferLock lock(this);
+        return linkBuffer->isReady(curTime);
+    }
+
+    inline flit* peekLink()
+    {
+        BufferLock lock(this);
+        return linkBuffer->peekTopFlit();
+    }
+
+    inline flit* consumeLink()
+    {
+        BufferLock lock(this);
+        return linkBuffer->getTopFlit();
+    }
 
     uint32_t functionalWrite(Packet *);
+    void startup();
+    DrainState drain() override;
+    void regStats();
+    void collateStats(double time_delta);
     void resetStats();
 
   protected:
+    // Holds the link buffer lock if the consumer is on another
+    // event queue (i.e., another thread) than this link
+    class BufferLock
+    {
+      public:
+        BufferLock(NetworkLink *link)
+            : m_lock(link->m_buffer_mutex, std::defer_lock)
+        {
+            if (link->m_cross_queue)
+                m_lock.lock();
+        }
+
+      private:
+        std::unique_lock<std::mutex> m_lock;
+    };
+
     const int m_id;
     link_type m_type;
     const Cycles m_latency;
@@ -85,9 +126,31 @@ class NetworkLink : public ClockedObject, public Consumer
 
     InputUnit *link_consumer_inport; // used by SMART for single-cycle bypass
 
+    // Parallel mode: linkBuffer is written by this link's thread and
+    // read by the consumer's
+    bool m_cross_queue;
+    std::mutex m_buffer_mutex;
+
     // Statistical variables
     unsigned int m_link_utilized;
     std::vector<unsigned int> m_vc_load;
+
+    // Per flit link, set by collateStats
+    Stats::Scalar m_flits;
+    Stats::Scalar m_utilization;
+
+    // Utilization time series (see GarnetNetwork), sampled on this
+    // link's event queue as that is where m_link_utilized is counted
+    void sampleUtilization();
+
+    GarnetNetwork *m_net_ptr;
+    int m_src;
+    int m_dest;
+    EventFunctionWrapper m_util_event;
+    bool m_sample_util;
+    Tick m_util_last_sample;
+    // m_link_utilized at the last sample
+    unsigned int m_util_flits;
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET2_0_NETWORKLINK_HH__
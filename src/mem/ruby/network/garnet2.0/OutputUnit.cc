@@ -44,7 +44,7 @@
 using namespace std;
 using m5::stl_helpers::deletePointers;
 
-OutputUnit::OutputUnit(int id, PortDirection direction, Router *router)
+OutputUnit::OutputUnit(int id, PortDirectionId direction, Router *router)
     : Consumer(router)
 {
     m_id = id;
@@ -118,6 +118,19 @@ OutputUnit::has_free_vc(int vnet)
 
 }
 
+// Free buffers at the next router in the VCs of this vnet.
+// Used by adaptive routing as a measure of congestion.
+int
+OutputUnit::get_vnet_credits(int vnet)
+{
+    int credits = 0;
+    int vc_base = vnet*m_vc_per_vnet;
+    for (int vc = vc_base; vc < vc_base + m_vc_per_vnet; vc++) {
+        credits += m_outvc_state[vc]->get_credit_count();
+    }
+    return credits;
+}
+
 // Assign a free output VC to the winner of Switch Allocation
 int
 OutputUnit::select_free_vc(int vnet)
@@ -197,10 +210,17 @@ OutputUnit::set_credit_link(CreditLink *credit_link)
 }
 
 // SMART NoC
+// SSRs are arbitrated as they arrive: the request slot for the SSR's
+// cycle only keeps the highest priority request, and an old request
+// left in the slot from an earlier cycle is simply overwritten.
 void
-OutputUnit::insertSSR(SSR *t_ssr)
+OutputUnit::insertSSR(const SSR& t_ssr)
 {
-    ssr_reqs.push(t_ssr);
+    SSR& slot = m_ssr_req[t_ssr.m_time % SSR_SLOTS_];
+
+    SMARTPriority prio = m_router->get_net_ptr()->getSMARTPriority();
+    if (!slot.is_valid(t_ssr.m_time) || t_ssr.has_priority_over(slot, prio))
+        slot = t_ssr;
 
     // Wake up Router next cycle for SA-G
     m_router->schedule_wakeup(Cycles(1));
@@ -210,47 +230,22 @@ OutputUnit::insertSSR(SSR *t_ssr)
 bool
 OutputUnit::isReadySSR()
 {
-    // delete invalid SSRs
-    while (!ssr_reqs.empty()) {
-        SSR *t_ssr = ssr_reqs.top();
-        if (t_ssr->get_time() < m_router->curCycle()) {
-            ssr_reqs.pop();
-            delete t_ssr;
-        } else if (t_ssr->get_time() == m_router->curCycle())
-            return true;
-        else
-            break;
-    }
-
-    return false;
+    Cycles curTime = m_router->curCycle();
+    return m_ssr_req[curTime % SSR_SLOTS_].is_valid(curTime);
 }
 
 // Get highest priority SSR
-SSR*
+// This also clears the request slot for this cycle
+SSR
 OutputUnit::getTopSSR()
 {
-    SSR *t_ssr = ssr_reqs.top();
-    ssr_reqs.pop();
+    SSR& slot = m_ssr_req[m_router->curCycle() % SSR_SLOTS_];
+    SSR t_ssr = slot;
+    slot.invalidate();
 
     return t_ssr;
 }
 
-// SSR has been granted
-// clear SSR request queue for this cycle
-void
-OutputUnit::clearSSRreqs()
-{
-    while (!ssr_reqs.empty()) {
-        SSR *t_ssr = ssr_reqs.top();
-        if (t_ssr->get_time() <= m_router->curCycle()) {
-            ssr_reqs.pop();
-            delete t_ssr;
-        } else {
-            break;
-        }
-    }
-}
-
 // Multi-hop bypass
 void
 OutputUnit::smart_bypass(flit *t_flit)
@@ -305,7 +300,7 @@ OutputUnit::print(std::ostream& out) const
 {
     out << "[OutputUnit:: ";
     out << "Id=" << m_id << " ";
-    out << "Dirn=" << m_direction << " ";
+    out << "Dirn=" << m_router->getPortDirectionName(m_direction) << " ";
     out << "No VCs=" << m_num_vcs <<  " ";
     out << "VC per vnet=" << m_vc_per_vnet << " ";
     out << "Router ID=" << m_router->get_id() << " ";
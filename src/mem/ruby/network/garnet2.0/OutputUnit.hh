@@ -44,12 +44,13 @@
 #include "mem/ruby/network/garnet2.0/NetworkLink.hh"
 #include "mem/ruby/network/garnet2.0/OutVcState.hh"
 #include "mem/ruby/network/garnet2.0/Router.hh"
+#include "mem/ruby/network/garnet2.0/SSR.hh"
 #include "mem/ruby/network/garnet2.0/flitBuffer.hh"
 
 class OutputUnit : public Consumer
 {
   public:
-    OutputUnit(int id, PortDirection direction, Router *router);
+    OutputUnit(int id, PortDirectionId direction, Router *router);
     ~OutputUnit();
     void set_out_link(NetworkLink *link);
     void set_credit_link(CreditLink *credit_link);
@@ -60,9 +61,10 @@ class OutputUnit : public Consumer
     void increment_credit(int out_vc);
     bool has_credit(int out_vc);
     bool has_free_vc(int vnet);
+    int get_vnet_credits(int vnet);
     int select_free_vc(int vnet);
 
-    inline PortDirection get_direction() { return m_direction; }
+    inline PortDirectionId get_direction() { return m_direction; }
 
     int
     get_credit_count(int vc)
@@ -100,10 +102,9 @@ class OutputUnit : public Consumer
     uint32_t functionalWrite(Packet *pkt);
 
     // SMART NoC
-    void insertSSR(SSR *t_ssr);
+    void insertSSR(const SSR& t_ssr);
     bool isReadySSR();
-    SSR* getTopSSR();
-    void clearSSRreqs();
+    SSR getTopSSR();
     void smart_bypass(flit *t_flit);
 
     flit* lastflit;
@@ -111,7 +112,7 @@ class OutputUnit : public Consumer
 
   private:
     int m_id;
-    PortDirection m_direction;
+    PortDirectionId m_direction;
     int m_num_vcs;
     int m_vc_per_vnet;
     Router *m_router;
@@ -122,20 +123,8 @@ class OutputUnit : public Consumer
     std::vector<OutVcState *> m_outvc_state; // vc state of downstream router
 
     // SMART
-    struct SSR_prio_local
-    {
-        bool operator()(const SSR *lhs, const SSR *rhs) const
-        {
-            if (lhs->m_time == rhs->m_time)
-                // reverse the following for prio_bypass
-                return lhs->m_src_hops > rhs->m_src_hops;
-            else
-                return lhs->m_time > rhs->m_time;
-        }
-    };
-
-    std::priority_queue<SSR*, std::vector<SSR*>, SSR_prio_local> ssr_reqs;
-    //std::priority_queue<SSR*, std::vector<SSR*>, SSR_prio_local> ssr_grant;
+    // Winning SSR request for this outport, per cycle
+    SSR m_ssr_req[SSR_SLOTS_];
 };
 
     inline std::ostream&
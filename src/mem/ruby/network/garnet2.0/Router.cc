@@ -50,12 +50,18 @@ using namespace std;
 using m5::stl_helpers::deletePointers;
 
 Router::Router(const Params *p)
-    : BasicRouter(p), Consumer(this)
+    : BasicRouter(p), Consumer(this),
+      m_util_event([this]{ sample_utilization(); },
+                   "Router utilization sample"),
+      m_sample_util(false), m_util_last_sample(0), m_util_flit_cycles(0),
+      m_util_occupancy_since(0), m_util_sa_requests(0), m_util_sa_grants(0),
+      m_util_smart_tries(0), m_util_smart_bypasses(0)
 {
     m_latency = p->latency;
     m_virtual_networks = p->virt_nets;
     m_vc_per_vnet = p->vcs_per_vnet;
     m_num_vcs = m_virtual_networks * m_vc_per_vnet;
+    m_buffered_flits = 0;
 
     m_routing_unit = new RoutingUnit(this);
     m_sw_alloc = new SwitchAllocator(this);
@@ -84,6 +90,64 @@ Router::init()
     m_switch->init();
 }
 
+void
+Router::startup()
+{
+    BasicRouter::startup();
+
+    m_sample_util = m_network_ptr->isSamplingUtilization();
+    if (m_sample_util) {
+        m_util_last_sample = curTick();
+        m_util_occupancy_since = curCycle();
+        schedule(m_util_event, m_network_ptr->nextUtilizationSample());
+    }
+}
+
+void
+Router::accumulate_occupancy()
+{
+    Cycles now = curCycle();
+    m_util_flit_cycles += m_buffered_flits * (now - m_util_occupancy_since);
+    m_util_occupancy_since = now;
+}
+
+void
+Router::sample_utilization()
+{
+    accumulate_occupancy();
+
+    Cycles window = ticksToCycles(curTick() - m_util_last_sample);
+    double sa_requests = m_sw_alloc->get_input_arbiter_activity();
+    double sa_grants = m_sw_alloc->get_output_arbiter_activity();
+
+    m_network_ptr->recordRouterUtilization(m_id,
+        window > 0 ? double(m_util_flit_cycles) / window : 0.0,
+        sa_requests - m_util_sa_requests, sa_grants - m_util_sa_grants,
+        m_util_smart_tries, m_util_smart_bypasses);
+
+    // Stop after a window with no activity, so that an idle network
+    // does not keep the simulation running
+    bool active = m_buffered_flits > 0 || m_util_flit_cycles > 0 ||
+        sa_requests != m_util_sa_requests || m_util_smart_tries > 0;
+
+    m_util_last_sample = curTick();
+    m_util_flit_cycles = 0;
+    m_util_sa_requests = sa_requests;
+    m_util_sa_grants = sa_grants;
+    m_util_smart_tries = 0;
+    m_util_smart_bypasses = 0;
+    if (active)
+        schedule(m_util_event, m_network_ptr->nextUtilizationSample());
+}
+
+DrainState
+Router::drain()
+{
+    if (m_util_event.scheduled())
+        deschedule(m_util_event);
+    return DrainState::Drained;
+}
+
 void
 Router::wakeup()
 {
@@ -112,7 +176,7 @@ Router::wakeup()
 }
 
 void
-Router::addInPort(PortDirection inport_dirn,
+Router::addInPort(PortDirectionId inport_dirn,
                   NetworkLink *in_link, CreditLink *credit_link)
 {
     int port_num = m_input_unit.size();
@@ -130,7 +194,7 @@ Router::addInPort(PortDirection inport_dirn,
 }
 
 void
-Router::addOutPort(PortDirection outport_dirn,
+Router::addOutPort(PortDirectionId outport_dirn,
                    NetworkLink *out_link,
                    const NetDest& routing_table_entry, int link_weight,
                    CreditLink *credit_link)
@@ -150,24 +214,32 @@ Router::addOutPort(PortDirection outport_dirn,
     m_routing_unit->addOutDirection(outport_dirn, port_num);
 }
 
-PortDirection
+PortDirectionId
 Router::getOutportDirection(int outport)
 {
     return m_output_unit[outport]->get_direction();
 }
 
-PortDirection
+PortDirectionId
 Router::getInportDirection(int inport)
 {
     return m_input_unit[inport]->get_direction();
 }
 
 int
-Router::route_compute(RouteInfo *route, int inport, PortDirection inport_dirn)
+Router::route_compute(RouteInfo *route, int inport,
+                      PortDirectionId inport_dirn)
 {
     return m_routing_unit->outportCompute(route, inport, inport_dirn);
 }
 
+PortDirectionId
+Router::peek_outport_dirn(RouteInfo& route,
+                          PortDirectionId inport_dirn)
+{
+    return m_routing_unit->peekOutportDirection(route, inport_dirn);
+}
+
 void
 Router::grant_switch(int inport, flit *t_flit)
 {
@@ -181,41 +253,41 @@ Router::schedule_wakeup(Cycles time)
     scheduleEvent(time);
 }
 
-std::string
-Router::getPortDirectionName(PortDirection direction)
+const std::string&
+Router::getPortDirectionName(PortDirectionId direction)
 {
-    // PortDirection is actually a string
-    // If not, then this function should add a switch
-    // statement to convert direction to a string
-    // that can be printed out
-    return direction;
+    // Directions are interned by the network;
+    // the name is only needed for printing
+    return m_network_ptr->getPortDirectionName(direction);
 }
 
 void
-Router::insertSSR(PortDirection inport_dirn, SSR* t_ssr)
+Router::insertSSR(PortDirectionId inport_dirn, SSR t_ssr)
 {
     DPRINTF(RubyNetwork, "Router %d Inport %s received SSR from src_hops %d for bypass = %d for Outport %s\n",
-            get_id(), inport_dirn, t_ssr->get_src_hops(), t_ssr->get_bypass_req(), t_ssr->get_outport_dirn());
+            get_id(), getPortDirectionName(inport_dirn),
+            t_ssr.get_src_hops(), t_ssr.get_bypass_req(),
+            getPortDirectionName(t_ssr.get_outport_dirn()));
 
     int inport = m_routing_unit->getInportIdx(inport_dirn);
-    int outport = m_routing_unit->getOutportIdx(t_ssr->get_outport_dirn());
+    int outport = m_routing_unit->getOutportIdx(t_ssr.get_outport_dirn());
 
-    t_ssr->set_inport(inport);
+    t_ssr.set_inport(inport);
 
     // Update SSR if dest bypass enabled
-    if (t_ssr->get_src_hops() > 0 && !t_ssr->get_bypass_req()) {
+    if (t_ssr.get_src_hops() > 0 && !t_ssr.get_bypass_req()) {
         // dest or turning router
-        RouteInfo* route = t_ssr->get_ref_flit()->get_route();
+        RouteInfo* route = t_ssr.get_ref_flit()->get_route();
         bool is_dest = (route->dest_router == m_id);
 
         if (get_net_ptr()->isSMARTdestBypass() && is_dest) {
-            outport = m_routing_unit->lookupRoutingTable(route->vnet, route->net_dest);
-            PortDirection outport_dirn = m_output_unit[outport]->get_direction();
+            outport = m_routing_unit->lookupRoutingTable(*route);
+            PortDirectionId outport_dirn =
+                m_output_unit[outport]->get_direction();
 
-            t_ssr->set_outport_dirn(outport_dirn);
-            t_ssr->set_bypass_req(true);
+            t_ssr.set_outport_dirn(outport_dirn);
+            t_ssr.set_bypass_req(true);
         } else {
-            delete t_ssr;
             return;
         }
     }
@@ -271,19 +343,28 @@ void
 Router::smart_route_update(int inport, int outport, flit* t_flit)
 {
     // Update route in flit
-    // Call route_compute so that x_hops/y_hops decremented
     DPRINTF(RubyNetwork, "[Router] flit %s at Inport %d %s\n" ,
-            *t_flit, inport, m_input_unit[inport]->get_direction());
-    int check_outport = route_compute(t_flit->get_route(),
-        inport, m_input_unit[inport]->get_direction());
-    DPRINTF(RubyNetwork, "check_outport %d outport %d\n",
-            check_outport, outport);
-    assert(check_outport == outport);
+            *t_flit, inport,
+            getPortDirectionName(m_input_unit[inport]->get_direction()));
+    if (m_routing_unit->isAdaptive()) {
+        // The SSR carried the direction chosen when it was sent;
+        // congestion may have changed since, so do not route again
+        t_flit->get_route()->outport_dirn =
+            m_output_unit[outport]->get_direction();
+    } else {
+        // Call route_compute so that x_hops/y_hops decremented
+        int check_outport = route_compute(t_flit->get_route(),
+            inport, m_input_unit[inport]->get_direction());
+        DPRINTF(RubyNetwork, "check_outport %d outport %d\n",
+                check_outport, outport);
+        assert(check_outport == outport);
+    }
     t_flit->set_outport(outport);
 }
 
 bool
-Router::try_smart_bypass(int inport, PortDirection outport_dirn, flit *t_flit)
+Router::try_smart_bypass(int inport, PortDirectionId outport_dirn,
+                         flit *t_flit)
 {
     int outport = m_routing_unit->getOutportIdx(outport_dirn);
 
@@ -304,8 +385,10 @@ Router::try_smart_bypass(int inport, PortDirection outport_dirn, flit *t_flit)
     // Update Route
     smart_route_update(inport, outport, t_flit);
 
-    DPRINTF(RubyNetwork, "Router %d Inport %s and Outport %d successful SMART Bypass for Flit %s\n",
-            get_id(), getPortDirectionName(m_input_unit[inport]->get_direction()), outport_dirn, *t_flit);
+    DPRINTF(RubyNetwork, "Router %d Inport %s and Outport %s successful "
+            "SMART Bypass for Flit %s\n", get_id(),
+            getPortDirectionName(m_input_unit[inport]->get_direction()),
+            getPortDirectionName(outport_dirn), *t_flit);
     DPRINTF(SMART, "[Router] try_smart_bypass VC= %d\n", t_flit->get_vc());
     // Add flit to output link
     if (t_flit->get_type() == HEAD_ || t_flit->get_type() == HEAD_TAIL_){
@@ -329,6 +412,7 @@ Router::try_smart_bypass(int inport, PortDirection outport_dirn, flit *t_flit)
             get_id());
     m_output_unit[outport]->smart_bypass(t_flit);
     t_flit->increment_hops(); // for stats
+    t_flit->extend_smart_hop();
 
     return true;
 }
@@ -362,6 +446,16 @@ Router::regStats()
         .name(name() + ".sw_output_arbiter_activity")
         .flags(Stats::nozero)
     ;
+
+    m_smart_hops
+        .name(name() + ".smart_hops")
+        .flags(Stats::nozero)
+    ;
+
+    m_smart_hop_routers
+        .name(name() + ".smart_hop_routers")
+        .flags(Stats::nozero)
+    ;
 }
 
 void
@@ -377,6 +471,43 @@ Router::collateStats()
     m_sw_input_arbiter_activity = m_sw_alloc->get_input_arbiter_activity();
     m_sw_output_arbiter_activity = m_sw_alloc->get_output_arbiter_activity();
     m_crossbar_activity = m_switch->get_crossbar_activity();
+
+    m_smart_hops = 0;
+    m_smart_hop_routers = 0;
+    for (int routers = 0; routers < m_smart_hop_counts.size(); routers++) {
+        m_smart_hops += m_smart_hop_counts[routers];
+        m_smart_hop_routers += routers * m_smart_hop_counts[routers];
+    }
+}
+
+double
+Router::get_buffer_reads() const
+{
+    double reads = 0;
+    for (int j = 0; j < m_virtual_networks; j++) {
+        for (int i = 0; i < m_input_unit.size(); i++) {
+            reads += m_input_unit[i]->get_buf_read_activity(j);
+        }
+    }
+    return reads;
+}
+
+double
+Router::get_buffer_writes() const
+{
+    double writes = 0;
+    for (int j = 0; j < m_virtual_networks; j++) {
+        for (int i = 0; i < m_input_unit.size(); i++) {
+            writes += m_input_unit[i]->get_buf_write_activity(j);
+        }
+    }
+    return writes;
+}
+
+double
+Router::get_crossbar_activity() const
+{
+    return m_switch->get_crossbar_activity();
 }
 
 void
@@ -390,6 +521,10 @@ Router::resetStats()
 
     m_switch->resetStats();
     m_sw_alloc->resetStats();
+    m_smart_hop_counts.clear();
+
+    m_util_sa_requests = 0;
+    m_util_sa_grants = 0;
 }
 
 void
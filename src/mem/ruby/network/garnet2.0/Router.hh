@@ -67,9 +67,11 @@ class Router : public BasicRouter, public Consumer
     void print(std::ostream& out) const {};
 
     void init();
-    void addInPort(PortDirection inport_dirn, NetworkLink *link,
+    void startup();
+    DrainState drain() override;
+    void addInPort(PortDirectionId inport_dirn, NetworkLink *link,
                    CreditLink *credit_link);
-    void addOutPort(PortDirection outport_dirn, NetworkLink *link,
+    void addOutPort(PortDirectionId outport_dirn, NetworkLink *link,
                     const NetDest& routing_table_entry,
                     int link_weight, CreditLink *credit_link);
 
@@ -89,32 +91,59 @@ class Router : public BasicRouter, public Consumer
     GarnetNetwork* get_net_ptr()                    { return m_network_ptr; }
     std::vector<InputUnit *>& get_inputUnit_ref()   { return m_input_unit; }
     std::vector<OutputUnit *>& get_outputUnit_ref() { return m_output_unit; }
-    PortDirection getOutportDirection(int outport);
-    PortDirection getInportDirection(int inport);
+    PortDirectionId getOutportDirection(int outport);
+    PortDirectionId getInportDirection(int inport);
 
-    int route_compute(RouteInfo *route, int inport, PortDirection direction);
+    int route_compute(RouteInfo *route, int inport,
+                      PortDirectionId direction);
+    PortDirectionId peek_outport_dirn(RouteInfo& route,
+                                      PortDirectionId inport_dirn);
     void grant_switch(int inport, flit *t_flit);
     void schedule_wakeup(Cycles time);
 
-    // SMART NoC
-    struct SSR_prio_local
+    // Flits held in the input VCs of this router, kept up to date by the
+    // InputUnits so that switch allocation can skip an idle router
+    void
+    update_buffered_flits(int delta)
     {
-        bool operator()(const SSR *lhs, const SSR *rhs) const
-        {
-            if (lhs->m_time == rhs->m_time)
-                // reverse the following for prio_bypass
-                return lhs->m_src_hops > rhs->m_src_hops;
-            else
-                return lhs->m_time > rhs->m_time;
+        if (m_sample_util) {
+            accumulate_occupancy();
+            // Sampling stops while the router is idle or drained, and
+            // restarts with the next flit
+            if (!m_util_event.scheduled())
+                schedule(m_util_event,
+                         m_network_ptr->nextUtilizationSample());
         }
-    };
+        m_buffered_flits += delta;
+    }
+    bool has_buffered_flits() const { return m_buffered_flits > 0; }
 
-    void insertSSR(PortDirection inport_dirn, SSR* t_ssr);
-    bool try_smart_bypass(int inport, PortDirection outport_dirn, flit* t_flit);
+    // SMART NoC
+    void insertSSR(PortDirectionId inport_dirn, SSR t_ssr);
+    bool try_smart_bypass(int inport, PortDirectionId outport_dirn,
+                          flit* t_flit);
     bool smart_vc_select(int inport, int outport, flit* t_flit);
     void smart_route_update(int inport, int outport, flit* t_flit);
 
-    std::string getPortDirectionName(PortDirection direction);
+    // Routers crossed per smart hop, added up by GarnetNetwork
+    void
+    sample_smart_hop(int routers)
+    {
+        if (routers <= 0)
+            return;
+        if (routers >= m_smart_hop_counts.size())
+            m_smart_hop_counts.resize(routers + 1, 0);
+        m_smart_hop_counts[routers]++;
+    }
+    const std::vector<uint64_t>& get_smart_hop_counts() const
+    { return m_smart_hop_counts; }
+
+    // SMART bypasses tried and taken at the inports of this router,
+    // for the utilization time series
+    void count_smart_try() { m_util_smart_tries++; }
+    void count_smart_bypass() { m_util_smart_bypasses++; }
+
+    const std::string& getPortDirectionName(PortDirectionId direction);
     void printFaultVector(std::ostream& out);
     void printAggregateFaultProbability(std::ostream& out);
 
@@ -122,6 +151,11 @@ class Router : public BasicRouter, public Consumer
     void collateStats();
     void resetStats();
 
+    // Activity since the last stats reset, for GarnetNetwork's report
+    double get_buffer_reads() const;
+    double get_buffer_writes() const;
+    double get_crossbar_activity() const;
+
     // For Fault Model:
     bool get_fault_vector(int temperature, float fault_vector[]) {
         return m_network_ptr->fault_model->fault_vector(m_id, temperature,
@@ -146,6 +180,7 @@ class Router : public BasicRouter, public Consumer
     RoutingUnit *m_routing_unit;
     SwitchAllocator *m_sw_alloc;
     CrossbarSwitch *m_switch;
+    int m_buffered_flits;
 
     // Statistical variables required for power computations
     Stats::Scalar m_buffer_reads;
@@ -155,6 +190,28 @@ class Router : public BasicRouter, public Consumer
     Stats::Scalar m_sw_output_arbiter_activity;
 
     Stats::Scalar m_crossbar_activity;
+
+    // SMART hops that ended at this router, and the routers they crossed
+    Stats::Scalar m_smart_hops;
+    Stats::Scalar m_smart_hop_routers;
+
+    std::vector<uint64_t> m_smart_hop_counts;
+
+    // Utilization time series (see GarnetNetwork)
+    void sample_utilization();
+    void accumulate_occupancy();
+
+    EventFunctionWrapper m_util_event;
+    bool m_sample_util;
+    Tick m_util_last_sample;
+    // Flit-cycles spent in the input VCs since the last sample
+    uint64_t m_util_flit_cycles;
+    Cycles m_util_occupancy_since;
+    // Switch allocator activity at the last sample
+    double m_util_sa_requests;
+    double m_util_sa_grants;
+    uint64_t m_util_smart_tries;
+    uint64_t m_util_smart_bypasses;
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET2_0_ROUTER_HH__
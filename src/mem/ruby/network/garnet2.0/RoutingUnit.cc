@@ -36,20 +36,25 @@
 #include "base/cast.hh"
 #include "base/logging.hh"
 #include "mem/ruby/network/garnet2.0/InputUnit.hh"
+#include "mem/ruby/network/garnet2.0/OutputUnit.hh"
 #include "mem/ruby/network/garnet2.0/Router.hh"
 #include "mem/ruby/slicc_interface/Message.hh"
 
 RoutingUnit::RoutingUnit(Router *router)
+    : m_rng(router->get_id())
 {
     m_router = router;
     m_routing_table.clear();
     m_weight_table.clear();
+    m_inports_dirn2idx.assign(MAX_PORT_DIRNS_, -1);
+    m_outports_dirn2idx.assign(MAX_PORT_DIRNS_, -1);
 }
 
 void
 RoutingUnit::addRoute(const NetDest& routing_table_entry)
 {
     m_routing_table.push_back(routing_table_entry);
+    m_dest_candidates.clear();
 }
 
 void
@@ -66,7 +71,7 @@ RoutingUnit::addWeight(int link_weight)
  */
 
 int
-RoutingUnit::lookupRoutingTable(int vnet, NetDest msg_destination)
+RoutingUnit::lookupRoutingTable(const RouteInfo& route)
 {
     // First find all possible output link candidates
     // For ordered vnet, just choose the first
@@ -76,13 +81,74 @@ RoutingUnit::lookupRoutingTable(int vnet, NetDest msg_destination)
     // different weights in the topology file
 
     int output_link = -1;
+    const std::vector<int>& output_link_candidates =
+        getRouteCandidates(route);
+    int num_candidates = output_link_candidates.size();
+
+    if (output_link_candidates.size() == 0) {
+        fatal("Fatal Error:: No Route exists from this Router.");
+        exit(0);
+    }
+
+    // Randomly select any candidate output link
+    int candidate = 0;
+    if (!(m_router->get_net_ptr())->isVNetOrdered(route.vnet))
+        candidate = m_rng.random<int>(0, num_candidates - 1);
+
+    output_link = output_link_candidates.at(candidate);
+    return output_link;
+}
+
+const std::vector<int>&
+RoutingUnit::getRouteCandidates(const RouteInfo& route)
+{
+    if (m_dest_candidates.empty())
+        compileRoutingTable();
+
+    // The NIs split multicast messages into one packet per destination,
+    // so a route normally leads to the single NI dest_ni
+    if (route.dest_ni >= 0 && route.dest_ni < m_dest_candidates.size())
+        return m_dest_candidates[route.dest_ni];
+
+    m_scan_candidates.clear();
+    scanRoutingTable(route.net_dest, m_scan_candidates);
+    return m_scan_candidates;
+}
+
+// Group the output links by the destinations they lead to, keeping the
+// minimum-weight ones, so that a lookup does not scan the table
+void
+RoutingUnit::compileRoutingTable()
+{
+    std::vector<int> min_weight;
+
+    for (int link = 0; link < m_routing_table.size(); link++) {
+        for (NodeID dest : m_routing_table[link].getAllDest()) {
+            if (dest >= m_dest_candidates.size()) {
+                m_dest_candidates.resize(dest + 1);
+                min_weight.resize(dest + 1, INFINITE_);
+            }
+
+            std::vector<int>& candidates = m_dest_candidates[dest];
+            if (m_weight_table[link] < min_weight[dest]) {
+                min_weight[dest] = m_weight_table[link];
+                candidates.clear();
+            }
+            if (m_weight_table[link] == min_weight[dest])
+                candidates.push_back(link);
+        }
+    }
+}
+
+void
+RoutingUnit::scanRoutingTable(const NetDest& net_dest,
+                              std::vector<int>& candidates)
+{
     int min_weight = INFINITE_;
-    std::vector<int> output_link_candidates;
-    int num_candidates = 0;
 
     // Identify the minimum weight among the candidate output links
     for (int link = 0; link < m_routing_table.size(); link++) {
-        if (msg_destination.intersectionIsNotEmpty(m_routing_table[link])) {
+        if (net_dest.intersectionIsNotEmpty(m_routing_table[link])) {
 
         if (m_weight_table[link] <= min_weight)
             min_weight = m_weight_table[link];
@@ -91,42 +157,75 @@ RoutingUnit::lookupRoutingTable(int vnet, NetDest msg_destination)
 
     // Collect all candidate output links with this minimum weight
     for (int link = 0; link < m_routing_table.size(); link++) {
-        if (msg_destination.intersectionIsNotEmpty(m_routing_table[link])) {
-
-            if (m_weight_table[link] == min_weight) {
+        if (net_dest.intersectionIsNotEmpty(m_routing_table[link])) {
 
-                num_candidates++;
-                output_link_candidates.push_back(link);
-            }
+            if (m_weight_table[link] == min_weight)
+                candidates.push_back(link);
         }
     }
+}
 
-    if (output_link_candidates.size() == 0) {
-        fatal("Fatal Error:: No Route exists from this Router.");
-        exit(0);
-    }
+// Used by SMART to find how far a flit will keep going in one direction.
+// Works on a copy of the route, so the flit's hop counters are untouched.
+// Adaptive algorithms do record the direction they pick for the packet.
+PortDirectionId
+RoutingUnit::peekOutportDirection(RouteInfo& route,
+                                  PortDirectionId inport_dirn)
+{
+    RoutingAlgorithm routing_algorithm =
+        (RoutingAlgorithm) m_router->get_net_ptr()->getRoutingAlgorithm();
 
-    // Randomly select any candidate output link
-    int candidate = 0;
-    if (!(m_router->get_net_ptr())->isVNetOrdered(vnet))
-        candidate = rand() % num_candidates;
+    int outport = -1;
 
-    output_link = output_link_candidates.at(candidate);
-    return output_link;
+    switch (routing_algorithm) {
+        case XY_: {
+            RouteInfo t_route = route;
+            outport = outportComputeXY(&t_route,
+                                       getInportIdx(inport_dirn),
+                                       inport_dirn);
+            break;
+        }
+        case WEST_FIRST_:
+        case ODD_EVEN_:
+            // Picked by the head flit, from the current credit
+            // counts, and kept by the rest of the packet
+            return adaptiveOutportDirection(route);
+        case CUSTOM_:
+            // unknown ahead of time
+            break;
+        default: {
+            // Unordered vnets pick randomly among equal-weight links,
+            // so only a single candidate is known ahead of time
+            const std::vector<int>& candidates = getRouteCandidates(route);
+            if (candidates.size() == 1)
+                outport = candidates[0];
+            break;
+        }
+    }
+
+    if (outport == -1)
+        return UNKNOWN_DIRN_;
+    return m_outports_idx2dirn[outport];
 }
 
 
 void
-RoutingUnit::addInDirection(PortDirection inport_dirn, int inport_idx)
+RoutingUnit::addInDirection(PortDirectionId inport_dirn, int inport_idx)
 {
+    assert(inport_dirn >= 0 && inport_dirn < MAX_PORT_DIRNS_);
     m_inports_dirn2idx[inport_dirn] = inport_idx;
+    if (m_inports_idx2dirn.size() <= inport_idx)
+        m_inports_idx2dirn.resize(inport_idx + 1, UNKNOWN_DIRN_);
     m_inports_idx2dirn[inport_idx]  = inport_dirn;
 }
 
 void
-RoutingUnit::addOutDirection(PortDirection outport_dirn, int outport_idx)
+RoutingUnit::addOutDirection(PortDirectionId outport_dirn, int outport_idx)
 {
+    assert(outport_dirn >= 0 && outport_dirn < MAX_PORT_DIRNS_);
     m_outports_dirn2idx[outport_dirn] = outport_idx;
+    if (m_outports_idx2dirn.size() <= outport_idx)
+        m_outports_idx2dirn.resize(outport_idx + 1, UNKNOWN_DIRN_);
     m_outports_idx2dirn[outport_idx]  = outport_dirn;
 }
 
@@ -138,7 +237,7 @@ RoutingUnit::addOutDirection(PortDirection outport_dirn, int outport_idx)
 
 int
 RoutingUnit::outportCompute(RouteInfo *route, int inport,
-                            PortDirection inport_dirn)
+                            PortDirectionId inport_dirn)
 {
     int outport = -1;
 
@@ -148,7 +247,7 @@ RoutingUnit::outportCompute(RouteInfo *route, int inport,
         // Multiple NIs may be connected to this router,
         // all with output port direction = "Local"
         // Get exact outport id from table
-        outport = lookupRoutingTable(route->vnet, route->net_dest);
+        outport = lookupRoutingTable(*route);
         return outport;
     }
     */
@@ -160,14 +259,17 @@ RoutingUnit::outportCompute(RouteInfo *route, int inport,
 
     switch (routing_algorithm) {
         case TABLE_:  outport =
-            lookupRoutingTable(route->vnet, route->net_dest); break;
+            lookupRoutingTable(*route); break;
         case XY_:     outport =
             outportComputeXY(route, inport, inport_dirn); break;
+        case WEST_FIRST_:
+        case ODD_EVEN_: outport =
+            outportComputeAdaptive(route, inport, inport_dirn); break;
         // any custom algorithm
         case CUSTOM_: outport =
             outportComputeCustom(route, inport, inport_dirn); break;
         default: outport =
-            lookupRoutingTable(route->vnet, route->net_dest); break;
+            lookupRoutingTable(*route); break;
     }
 
     assert(outport != -1);
@@ -180,9 +282,9 @@ RoutingUnit::outportCompute(RouteInfo *route, int inport,
 int
 RoutingUnit::outportComputeXY(RouteInfo *route,
                               int inport,
-                              PortDirection inport_dirn)
+                              PortDirectionId inport_dirn)
 {
-    PortDirection outport_dirn = "Unknown";
+    PortDirectionId outport_dirn = UNKNOWN_DIRN_;
 
     int M5_VAR_USED num_rows = m_router->get_net_ptr()->getNumRows();
     int num_cols = m_router->get_net_ptr()->getNumCols();
@@ -202,13 +304,13 @@ RoutingUnit::outportComputeXY(RouteInfo *route,
     bool x_dirn = (dest_x >= my_x);
     bool y_dirn = (dest_y >= my_y);
 
-    if (inport_dirn == "Local") {
+    if (inport_dirn == LOCAL_) {
         // Initialize
         route->x_hops_remaining = x_hops;
         route->y_hops_remaining = y_hops;
-    } else if (inport_dirn == "West" || inport_dirn == "East") {
+    } else if (inport_dirn == WEST_ || inport_dirn == EAST_) {
         route->x_hops_remaining--;
-    } else if (inport_dirn == "North" || inport_dirn == "South") {
+    } else if (inport_dirn == NORTH_ || inport_dirn == SOUTH_) {
         route->y_hops_remaining--;
     } else {
         assert(0);
@@ -216,25 +318,25 @@ RoutingUnit::outportComputeXY(RouteInfo *route,
 
     if (x_hops == 0 && y_hops == 0) {
         // lookup routing table for exact outport
-        route->outport_dirn = "Local";
-        return lookupRoutingTable(route->vnet, route->net_dest);
+        route->outport_dirn = LOCAL_;
+        return lookupRoutingTable(*route);
     } else if (x_hops > 0) {
         if (x_dirn) {
-            assert(inport_dirn == "Local" || inport_dirn == "West");
-            outport_dirn = "East";
+            assert(inport_dirn == LOCAL_ || inport_dirn == WEST_);
+            outport_dirn = EAST_;
         } else {
-            assert(inport_dirn == "Local" || inport_dirn == "East");
-            outport_dirn = "West";
+            assert(inport_dirn == LOCAL_ || inport_dirn == EAST_);
+            outport_dirn = WEST_;
         }
     } else if (y_hops > 0) {
         if (y_dirn) {
             // "Local" or "South" or "West" or "East"
-            assert(inport_dirn != "North");
-            outport_dirn = "North";
+            assert(inport_dirn != NORTH_);
+            outport_dirn = NORTH_;
         } else {
             // "Local" or "North" or "West" or "East"
-            assert(inport_dirn != "South");
-            outport_dirn = "South";
+            assert(inport_dirn != SOUTH_);
+            outport_dirn = SOUTH_;
         }
     } else {
         // x_hops == 0 and y_hops == 0
@@ -247,12 +349,135 @@ RoutingUnit::outportComputeXY(RouteInfo *route,
     return m_outports_dirn2idx[outport_dirn];
 }
 
+// Minimal adaptive routing implemented using port directions.
+// Only for a Mesh. The turn model limits the productive directions a
+// flit may take at this router so that no cycle of turns (and hence no
+// deadlock) can form; among those, the flit takes the one with the most
+// free buffers downstream.
+//  - West-first: all hops to the west are taken first
+//  - Odd-even: no east-to-north/south turn in an even column, and no
+//    north/south-to-west turn in an odd column
+// Flits of ordered vnets always take the first allowed direction
+// (x before y), so every packet between two nodes follows one path.
+int
+RoutingUnit::outportComputeAdaptive(RouteInfo *route,
+                                    int inport,
+                                    PortDirectionId inport_dirn)
+{
+    PortDirectionId outport_dirn = adaptiveOutportDirection(*route);
+    route->outport_dirn = outport_dirn;
+
+    if (outport_dirn == LOCAL_) {
+        // lookup routing table for exact outport
+        return lookupRoutingTable(*route);
+    }
+    return m_outports_dirn2idx[outport_dirn];
+}
+
+PortDirectionId
+RoutingUnit::adaptiveOutportDirection(RouteInfo& route)
+{
+    // Without SMART a packet is only routed once per router, by its
+    // head flit. With SMART every flit's SSR looks ahead, and a body
+    // flit choosing again from the credits could leave through another
+    // outport than the VC allocated to the packet.
+    if (!m_router->get_net_ptr()->isSMART())
+        return chooseAdaptiveDirection(route);
+
+    int my_id = m_router->get_id();
+    for (int i = 0; i < route.num_adaptive_dirns; i++) {
+        if (route.adaptive_dirns[i].first == my_id)
+            return route.adaptive_dirns[i].second;
+    }
+
+    PortDirectionId outport_dirn = chooseAdaptiveDirection(route);
+    assert(route.num_adaptive_dirns < MAX_ADAPTIVE_ROUTERS_);
+    route.adaptive_dirns[route.num_adaptive_dirns++] =
+        std::make_pair(my_id, outport_dirn);
+    return outport_dirn;
+}
+
+PortDirectionId
+RoutingUnit::chooseAdaptiveDirection(const RouteInfo& route)
+{
+    GarnetNetwork *net_ptr = m_router->get_net_ptr();
+    RoutingAlgorithm routing_algorithm =
+        (RoutingAlgorithm) net_ptr->getRoutingAlgorithm();
+
+    int M5_VAR_USED num_rows = net_ptr->getNumRows();
+    int num_cols = net_ptr->getNumCols();
+    assert(num_rows > 0 && num_cols > 0);
+
+    int my_id = m_router->get_id();
+    int my_x = my_id % num_cols;
+    int my_y = my_id / num_cols;
+
+    int src_x = route.src_router % num_cols;
+
+    int dest_id = route.dest_router;
+    int dest_x = dest_id % num_cols;
+    int dest_y = dest_id / num_cols;
+
+    int x_hops = dest_x - my_x;
+    int y_hops = dest_y - my_y;
+
+    if (x_hops == 0 && y_hops == 0)
+        return LOCAL_;
+
+    bool x_allowed = (x_hops != 0);
+    bool y_allowed = (y_hops != 0);
+
+    if (routing_algorithm == WEST_FIRST_) {
+        // no turn into the west: finish going west first
+        if (x_hops < 0)
+            y_allowed = false;
+    } else {
+        assert(routing_algorithm == ODD_EVEN_);
+        if (x_hops > 0 && y_hops != 0) {
+            // may only turn north/south in an odd column
+            // (or where the flit was injected)
+            y_allowed = (my_x % 2 == 1 || my_x == src_x);
+            // must not reach an even dest column with y hops left
+            x_allowed = (dest_x % 2 == 1 || x_hops != 1);
+        } else if (x_hops < 0) {
+            // a north/south flit may only turn west in an even column
+            y_allowed = y_allowed && (my_x % 2 == 0);
+        }
+    }
+    assert(x_allowed || y_allowed);
+
+    PortDirectionId x_dirn = (x_hops > 0) ? EAST_ : WEST_;
+    PortDirectionId y_dirn = (y_hops > 0) ? NORTH_ : SOUTH_;
+
+    if (!y_allowed)
+        return x_dirn;
+    if (!x_allowed || net_ptr->isVNetOrdered(route.vnet))
+        return x_allowed ? x_dirn : y_dirn;
+
+    // Both directions are productive: pick the less congested one
+    std::vector<OutputUnit *>& output_units = m_router->get_outputUnit_ref();
+    int x_credits = output_units[m_outports_dirn2idx[x_dirn]]->
+        get_vnet_credits(route.vnet);
+    int y_credits = output_units[m_outports_dirn2idx[y_dirn]]->
+        get_vnet_credits(route.vnet);
+
+    return (y_credits > x_credits) ? y_dirn : x_dirn;
+}
+
+bool
+RoutingUnit::isAdaptive()
+{
+    int routing_algorithm = m_router->get_net_ptr()->getRoutingAlgorithm();
+    return (routing_algorithm == WEST_FIRST_ ||
+            routing_algorithm == ODD_EVEN_);
+}
+
 // Template for implementing custom routing algorithm
 // using port directions. (Example adaptive)
 int
 RoutingUnit::outportComputeCustom(RouteInfo *route,
                                  int inport,
-                                 PortDirection inport_dirn)
+                                 PortDirectionId inport_dirn)
 {
     panic("%s placeholder executed", __FUNCTION__);
 }
@@ -34,6 +34,7 @@
 #ifndef __MEM_RUBY_NETWORK_GARNET2_0_ROUTINGUNIT_HH__
 #define __MEM_RUBY_NETWORK_GARNET2_0_ROUTINGUNIT_HH__
 
+#include "base/random.hh"
 #include "mem/ruby/common/Consumer.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
@@ -49,44 +50,95 @@ class RoutingUnit
     RoutingUnit(Router *router);
     int outportCompute(RouteInfo *route,
                       int inport,
-                      PortDirection inport_dirn);
+                      PortDirectionId inport_dirn);
 
-    int getInportIdx(PortDirection dirn) { return m_inports_dirn2idx[dirn]; }
-    int getOutportIdx(PortDirection dirn) { return m_outports_dirn2idx[dirn]; }
+    int
+    getInportIdx(PortDirectionId dirn)
+    {
+        assert(dirn >= 0 && dirn < MAX_PORT_DIRNS_);
+        assert(m_inports_dirn2idx[dirn] != -1);
+        return m_inports_dirn2idx[dirn];
+    }
+
+    int
+    getOutportIdx(PortDirectionId dirn)
+    {
+        assert(dirn >= 0 && dirn < MAX_PORT_DIRNS_);
+        assert(m_outports_dirn2idx[dirn] != -1);
+        return m_outports_dirn2idx[dirn];
+    }
 
     // Topology-agnostic Routing Table based routing (default)
     void addRoute(const NetDest& routing_table_entry);
     void addWeight(int link_weight);
 
     // get output port from routing table
-    int  lookupRoutingTable(int vnet, NetDest net_dest);
+    int  lookupRoutingTable(const RouteInfo& route);
+
+    // SMART NoC: direction a flit arriving at inport_dirn would leave in,
+    // without touching its route. UNKNOWN_DIRN_ if this is not decided yet
+    // (e.g., more than one candidate in the routing table)
+    PortDirectionId peekOutportDirection(RouteInfo& route,
+                                         PortDirectionId inport_dirn);
 
     // Topology-specific direction based routing
-    void addInDirection(PortDirection inport_dirn, int inport);
-    void addOutDirection(PortDirection outport_dirn, int outport);
+    void addInDirection(PortDirectionId inport_dirn, int inport);
+    void addOutDirection(PortDirectionId outport_dirn, int outport);
 
     // Routing for Mesh
     int outportComputeXY(RouteInfo *route,
                          int inport,
-                         PortDirection inport_dirn);
+                         PortDirectionId inport_dirn);
+
+    // Minimal adaptive routing for Mesh
+    // (west-first and odd-even turn models)
+    int outportComputeAdaptive(RouteInfo *route,
+                               int inport,
+                               PortDirectionId inport_dirn);
+    bool isAdaptive();
 
     // Custom Routing Algorithm using Port Directions
     int outportComputeCustom(RouteInfo *route,
                              int inport,
-                             PortDirection inport_dirn);
+                             PortDirectionId inport_dirn);
 
   private:
+    // output links with the minimum weight towards the route's dest
+    const std::vector<int>& getRouteCandidates(const RouteInfo& route);
+    void scanRoutingTable(const NetDest& net_dest,
+                          std::vector<int>& candidates);
+    void compileRoutingTable();
+
+    // direction picked by the adaptive routing algorithm
+    // (LOCAL_ at the destination router), the same for all the flits
+    // of a packet
+    PortDirectionId adaptiveOutportDirection(RouteInfo& route);
+    PortDirectionId chooseAdaptiveDirection(const RouteInfo& route);
+
     Router *m_router;
 
+    // Picks among equal-weight links. One generator per router keeps the
+    // choices independent of the order routers wake up in, so a run with
+    // routers on several threads matches the serial one.
+    Random m_rng;
+
     // Routing Table
     std::vector<NetDest> m_routing_table;
     std::vector<int> m_weight_table;
 
+    // Routing table compiled on first use: the candidate output links
+    // towards each destination NI, in link order
+    std::vector<std::vector<int> > m_dest_candidates;
+    // Candidates for a route that is not to a single NI
+    std::vector<int> m_scan_candidates;
+
     // Inport and Outport direction to idx maps
-    std::map<PortDirection, int> m_inports_dirn2idx;
-    std::map<int, PortDirection> m_inports_idx2dirn;
-    std::map<int, PortDirection> m_outports_idx2dirn;
-    std::map<PortDirection, int> m_outports_dirn2idx;
+    // (directions are interned, so these are plain arrays;
+    //  -1 means no port in that direction)
+    std::vector<int> m_inports_dirn2idx;
+    std::vector<PortDirectionId> m_inports_idx2dirn;
+    std::vector<PortDirectionId> m_outports_idx2dirn;
+    std::vector<int> m_outports_dirn2idx;
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET2_0_ROUTINGUNIT_HH__
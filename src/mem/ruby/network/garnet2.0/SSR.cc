@@ -32,7 +32,7 @@
 #include "mem/ruby/network/garnet2.0/SSR.hh"
 
 SSR::SSR(int vnet, int src_hops, bool bypass_req,
-         PortDirection outport_dirn, flit* ref_flit, Cycles curTime)
+         PortDirectionId outport_dirn, flit* ref_flit, Cycles curTime)
 {
     m_vnet = vnet;
     m_src_hops = src_hops;
@@ -40,5 +40,7 @@ SSR::SSR(int vnet, int src_hops, bool bypass_req,
     m_inport = -1;
     m_outport_dirn = outport_dirn;
     m_ref_flit = ref_flit;
+    m_ref_pid = ref_flit->get_pid();
+    m_ref_id = ref_flit->get_id();
     m_time = curTime;
 }
@@ -37,7 +37,6 @@
 
 #include "base/types.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
-#include "mem/ruby/network/garnet2.0/GarnetNetwork.hh"
 #include "mem/ruby/network/garnet2.0/flit.hh"
 
 // SSR Signal
@@ -45,13 +44,18 @@
 // m_src_hops,
 // m_vnet,
 // and *m_ref_flit (pointer to the flit it corresponds to)
+//
+// SSRs are small values: a router keeps one request slot per outport
+// and one grant slot per inport for each of the next two cycles
+// (see OutputUnit::insertSSR and InputUnit::grantSSR), and arbitration
+// happens when an SSR is written into a slot. Nothing is allocated.
 
-class SSR //: public flit
+class SSR
 {
   public:
-    SSR() {};
+    SSR() : m_ref_flit(NULL), m_time(0) {};
     SSR(int vnet, int src_hops, bool bypass_req,
-        PortDirection outport_dirn,
+        PortDirectionId outport_dirn,
         flit* ref_flit, Cycles curTime);
 
     int get_vnet()        { return m_vnet; }
@@ -66,24 +70,59 @@ class SSR //: public flit
         m_inport = inport;
     }
     int get_inport() { return m_inport; }
-    PortDirection
+    PortDirectionId
         get_outport_dirn(){ return m_outport_dirn; }
-    void set_outport_dirn(PortDirection outport_dirn)
+    void set_outport_dirn(PortDirectionId outport_dirn)
     {
         m_outport_dirn = outport_dirn;
     }
     flit* get_ref_flit()  { return m_ref_flit; }
+    // Flits are recycled, so match on the packet/flit id as well
+    // as the pointer
+    bool refers_to(flit* t_flit)
+    {
+        return (t_flit == m_ref_flit &&
+                t_flit->get_pid() == m_ref_pid &&
+                t_flit->get_id() == m_ref_id);
+    }
     Cycles get_time()     { return m_time; }
     void set_time(Cycles time) { m_time = time; }
 
+    // A slot holds a valid SSR for this cycle
+    bool
+    is_valid(Cycles time)
+    {
+        return m_ref_flit != NULL && m_time == time;
+    }
+    void invalidate()     { m_ref_flit = NULL; }
+
+    // Prio = Local: a flit starting at a router (0 hops) always beats
+    // flits bypassing it, as it was already sent to ST after SA-L.
+    // Among bypassing flits, prio picks the closest or farthest source.
+    bool
+    has_priority_over(const SSR& other, SMARTPriority prio) const
+    {
+        if (m_src_hops == 0 || other.m_src_hops == 0 ||
+            prio == SMART_PRIO_CLOSEST_)
+            return m_src_hops < other.m_src_hops;
+
+        return m_src_hops > other.m_src_hops;
+    }
+
 //  private:
     int m_vnet;
     int m_src_hops;
     bool m_bypass_req;
     int m_inport;
-    PortDirection m_outport_dirn;
+    PortDirectionId m_outport_dirn;
     flit* m_ref_flit;
+    int m_ref_pid;
+    int m_ref_id;
     Cycles m_time;
 };
 
+// Slots per SSR request/grant table: an SSR is written in cycle t
+// for cycle t+1, while the slot for cycle t may still be read.
+#define SSR_SLOTS_ 2
+
 #endif // __MEM_RUBY_NETWORK_GARNET_SSR_HH__
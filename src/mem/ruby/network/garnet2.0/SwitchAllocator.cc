@@ -65,6 +65,8 @@ SwitchAllocator::init()
     m_round_robin_invc.resize(m_num_inports);
     m_port_requests.resize(m_num_outports);
     m_vc_winners.resize(m_num_outports);
+    m_outport_requests.resize(m_num_outports, 0);
+    m_requested_outports.reserve(m_num_outports);
 
     for (int i = 0; i < m_num_inports; i++) {
         m_round_robin_invc[i] = 0;
@@ -89,16 +91,20 @@ SwitchAllocator::init()
  * There is no separate VCAllocator stage like the one in garnet1.0.
  * At the end of this function, the router is rescheduled to wakeup
  * next cycle for peforming SA for any flits ready next cycle.
+ * A router with no buffered flits has nothing to allocate and only
+ * performs SA-G.
  */
 
 void
 SwitchAllocator::wakeup()
 {
-    arbitrate_inports(); // First stage of allocation
-    arbitrate_outports(); // Second stage of allocation
+    if (m_router->has_buffered_flits()) {
+        arbitrate_inports(); // First stage of allocation
+        arbitrate_outports(); // Second stage of allocation
 
-    clear_request_vector();
-    check_for_wakeup();
+        clear_request_vector();
+        check_for_wakeup();
+    }
 
     // SA-G
     arbitrate_ssr();
@@ -120,6 +126,9 @@ SwitchAllocator::arbitrate_inports()
     // Select a VC from each input in a round robin manner
     // Independent arbiter at each input port
     for (int inport = 0; inport < m_num_inports; inport++) {
+        if (!m_input_unit[inport]->has_buffered_flits())
+            continue;
+
         int invc = m_round_robin_invc[inport];
 
         for (int invc_iter = 0; invc_iter < m_num_vcs; invc_iter++) {
@@ -157,6 +166,8 @@ SwitchAllocator::arbitrate_inports()
                     m_input_arbiter_activity++;
                     m_port_requests[outport][inport] = true;
                     m_vc_winners[outport][inport]= invc;
+                    if (m_outport_requests[outport]++ == 0)
+                        m_requested_outports.push_back(outport);
 
                     // Update Round Robin pointer to the next VC
                     m_round_robin_invc[inport] = invc + 1;
@@ -194,7 +205,15 @@ SwitchAllocator::arbitrate_outports()
     // Now there are a set of input vc requests for output vcs.
     // Again do round robin arbitration on these requests
     // Independent arbiter at each output port
+    if (m_requested_outports.empty())
+        return;
+
     for (int outport = 0; outport < m_num_outports; outport++) {
+        // outports are still visited in order, as SSRs sent
+        // below are prioritized by arrival on a tie
+        if (m_outport_requests[outport] == 0)
+            continue;
+
         int inport = m_round_robin_inport[outport];
 
         for (int inport_iter = 0; inport_iter < m_num_inports;
@@ -216,8 +235,8 @@ SwitchAllocator::arbitrate_outports()
                 flit *t_flit = m_input_unit[inport]->getTopFlit(invc);
 
                 DPRINTF(RubyNetwork, "SwitchAllocator at Router %d "
-                                     "granted outvc %d at outport %d "
-                                     "to invc %d at inport %d to flit %s at "
+                                     "granted outvc %d at outport %s "
+                                     "to invc %d at inport %s to flit %s at "
                                      "time: %lld\n",
                         m_router->get_id(), outvc,
                         m_router->getPortDirectionName(
@@ -266,51 +285,41 @@ SwitchAllocator::arbitrate_outports()
                     // In reality, SSR + SA-G will happen in the same cycle
 
                     // Local SSR (for self)
-                    SSR *t_ssr = new SSR(t_flit->get_vnet(),
-                                    0, // 0 hops
-                                    false, // no bypass req
-                                    m_output_unit[outport]->get_direction(),
-                                    t_flit,
-                                    m_router->curCycle() + Cycles(1));
-
-                    m_router->insertSSR(m_input_unit[inport]->get_direction(), t_ssr);
-
-                    // SSRs to neighbors
-                    // number of hops to bypass
+                    SSR t_ssr(t_flit->get_vnet(),
+                              0, // 0 hops
+                              false, // no bypass req
+                              m_output_unit[outport]->get_direction(),
+                              t_flit,
+                              m_router->curCycle() + Cycles(1));
+
+                    m_router->insertSSR(m_input_unit[inport]->get_direction(),
+                                        t_ssr);
+
+                    // SSRs to neighbors, along the flit's route
+                    // (up to the next turn or dest with SMART_1D,
+                    //  through turns with SMART_2D)
                     RouteInfo *route = t_flit->get_route();
                     // DPRINTF(SMART, "[SA] flit %s\n", *t_flit);
-                    // XY Routing
-                    int hops_remaining = (route->x_hops_remaining > 0) ? 
-                                          route->x_hops_remaining :
-                                          route->y_hops_remaining;
-                    int hpc_max = net_ptr->getHPCmax();
-                    int req_hops = std::min(hops_remaining, hpc_max);
-
-                    DPRINTF(SMART, "[SA] x %d y %d r %d\n",
-                            route->x_hops_remaining,
-                            route->y_hops_remaining,
-                            req_hops);
-
-                    if (req_hops > 0) {
-                    
-                        SSR* t_ssr = new SSR(t_flit->get_vnet(), req_hops,
-                            // arbitrary. SSR is replicated at every router
-                            // and actual value set
-                            true,
+                    SSR ssr(t_flit->get_vnet(),
+                            // arbitrary. SSR is replicated at every
+                            // router and actual value set
+                            0, true,
                             m_output_unit[outport]->get_direction(),
                             t_flit,
-                            m_router->curCycle() + Cycles(1)); // valid for next cycle
-                        DPRINTF(RubyNetwork,
-                        "Router %d Output port %s Sending SSR for hops = %d\n",
-                        m_router->get_id(),
+                            // valid for next cycle
+                            m_router->curCycle() + Cycles(1));
+
+                    // SSR Traversal is magical right now
+                    int req_hops = net_ptr->sendSSR(m_router->get_id(),
                         m_output_unit[outport]->get_direction(),
-                        req_hops);
+                        route, net_ptr->getHPCmax(), ssr);
 
-                        // SSR Traversal is magical right now
-                        net_ptr->sendSSR(m_router->get_id(),
-                                         m_output_unit[outport]->get_direction(),
-                                         req_hops, t_ssr);
-                    }
+                    DPRINTF(RubyNetwork,
+                    "Router %d Output port %s Sent SSR for hops = %d\n",
+                    m_router->get_id(),
+                    m_router->getPortDirectionName(
+                        m_output_unit[outport]->get_direction()),
+                    req_hops);
 
                 } else {
                     DPRINTF(RubyNetwork, "Baseline NoC");
@@ -464,6 +473,9 @@ SwitchAllocator::check_for_wakeup()
     Cycles nextCycle = m_router->curCycle() + Cycles(1);
 
     for (int i = 0; i < m_num_inports; i++) {
+        if (!m_input_unit[i]->has_buffered_flits())
+            continue;
+
         for (int j = 0; j < m_num_vcs; j++) {
             if (m_input_unit[i]->need_stage(j, SA_, nextCycle)) {
                 m_router->schedule_wakeup(Cycles(1));
@@ -487,11 +499,13 @@ SwitchAllocator::get_vnet(int invc)
 void
 SwitchAllocator::clear_request_vector()
 {
-    for (int i = 0; i < m_num_outports; i++) {
+    for (auto i : m_requested_outports) {
         for (int j = 0; j < m_num_inports; j++) {
             m_port_requests[i][j] = false;
         }
+        m_outport_requests[i] = 0;
     }
+    m_requested_outports.clear();
 }
 
 // SMART NoC
@@ -501,20 +515,15 @@ SwitchAllocator::arbitrate_ssr()
 {
     for (int o = 0; o < m_num_outports; o++) {
 
-        // Read SSR at the top of the SSR request queue (Highest Priority)   
+        // The request slot holds the highest priority SSR for this cycle
         if (m_output_unit[o]->isReadySSR()) {
 
-            // Grant SSR at head of prio queue
-            // as it has highest priority
-            SSR* t_ssr = m_output_unit[o]->getTopSSR();
-
-            //DPRINTF(RubyNetwork, "SwitchAllocator at Rourer %d granting SSR for inport %d for outport %d", m_router->get_id(), m_router->getPortDirectionName(m_input_unit[t_ssr->get_inport()]->get_direction()), m_router->getPortDirectionName(m_output_unit[o]->get_direction()));
-
-            // Push grant to prio queue in input unit
-            m_input_unit[t_ssr->get_inport()]->grantSSR(t_ssr);
+            // Grant it
+            // (also clears the request slot for this cycle)
+            SSR t_ssr = m_output_unit[o]->getTopSSR();
 
-            // Clear SSR request queue for this cycle
-            m_output_unit[o]->clearSSRreqs();
+            // Record grant in input unit
+            m_input_unit[t_ssr.get_inport()]->grantSSR(t_ssr);
         }
     }
 }
@@ -85,6 +85,10 @@ class SwitchAllocator : public Consumer
     std::vector<int> m_round_robin_invc;
     std::vector<int> m_round_robin_inport;
     std::vector<std::vector<bool>> m_port_requests;
+    // Requests placed at each outport during SA-I, and the outports
+    // that received any, so that SA-II only visits those
+    std::vector<int> m_outport_requests;
+    std::vector<int> m_requested_outports;
     std::vector<std::vector<int>> m_vc_winners; // a list for each outport
     std::vector<InputUnit *> m_input_unit;
     std::vector<OutputUnit *> m_output_unit;
@@ -38,10 +38,11 @@
 #include <iostream>
 
 #include "base/types.hh"
+#include "mem/ruby/common/ObjectPool.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
 #include "mem/ruby/slicc_interface/Message.hh"
 
-class flit
+class flit : public PooledObject<flit>
 {
   public:
     int m_pid;
@@ -75,6 +76,18 @@ class flit
     void set_id(int i) {m_id = i;}
     void increment_hops() { m_route->hops_traversed++; }
     void increment_smart_hops() { m_route->smart_hops_traversed++; }
+
+    // Routers crossed by this flit in its current smart hop (one cycle).
+    // The route is shared by all flits of a packet, so this lives here.
+    void start_smart_hop() { m_smart_hop_routers = 1; }
+    void extend_smart_hop() { m_smart_hop_routers++; }
+    int
+    end_smart_hop()
+    {
+        int routers = m_smart_hop_routers;
+        m_smart_hop_routers = 0;
+        return routers;
+    }
     void print(std::ostream& out) const;
 
     bool
@@ -117,6 +130,7 @@ class flit
     Cycles src_delay;
     int injection_router;
     std::pair<flit_stage, Cycles> m_stage;
+    int m_smart_hop_routers;
 };
 
 inline std::ostream&
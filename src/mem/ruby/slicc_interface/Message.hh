@@ -30,17 +30,21 @@
 #define __MEM_RUBY_SLICC_INTERFACE_MESSAGE_HH__
 
 #include <iostream>
-#include <memory>
 #include <stack>
 
+#include "base/refcnt.hh"
 #include "mem/packet.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/protocol/MessageSizeType.hh"
 
 class Message;
-typedef std::shared_ptr<Message> MsgPtr;
 
-class Message
+// Messages are reference counted intrusively, and without atomics: a
+// message is only ever handled by the thread running the controllers
+// and network interfaces that send and receive it.
+typedef RefCountingPtr<Message> MsgPtr;
+
+class Message : public RefCounted
 {
   public:
     Message(Tick curTime)
@@ -126,6 +130,13 @@ operator>(const MsgPtr &lhs, const MsgPtr &rhs)
     return l->getLastEnqueueTime() > r->getLastEnqueueTime();
 }
 
+inline std::ostream&
+operator<<(std::ostream& out, const MsgPtr& obj)
+{
+    out << obj.get();
+    return out;
+}
+
 inline std::ostream&
 operator<<(std::ostream& out, const Message& obj)
 {
@@ -34,6 +34,7 @@
 
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/common/DataBlock.hh"
+#include "mem/ruby/common/ObjectPool.hh"
 #include "mem/ruby/common/WriteMask.hh"
 #include "mem/ruby/protocol/HSAScope.hh"
 #include "mem/ruby/protocol/HSASegment.hh"
@@ -42,7 +43,7 @@
 #include "mem/ruby/protocol/RubyAccessMode.hh"
 #include "mem/ruby/protocol/RubyRequestType.hh"
 
-class RubyRequest : public Message
+class RubyRequest : public Message, public PooledObject<RubyRequest>
 {
   public:
     Addr m_PhysicalAddress;
@@ -142,7 +143,7 @@ class RubyRequest : public Message
 
     RubyRequest(Tick curTime) : Message(curTime) {}
     MsgPtr clone() const
-    { return std::shared_ptr<Message>(new RubyRequest(*this)); }
+    { return MsgPtr(new RubyRequest(*this)); }
 
     Addr getLineAddress() const { return m_LineAddress; }
     Addr getPhysicalAddress() const { return m_PhysicalAddress; }
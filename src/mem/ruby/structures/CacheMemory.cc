@@ -86,6 +86,7 @@ CacheMemory::init()
 
     m_cache.resize(m_cache_num_sets,
                     std::vector<AbstractCacheEntry*>(m_cache_assoc, nullptr));
+    m_tags.resize(m_cache_num_sets * m_cache_assoc, MaxAddr);
     replacement_data.resize(m_cache_num_sets,
                                std::vector<ReplData>(m_cache_assoc, nullptr));
     // instantiate all the replacement_data here
@@ -122,13 +123,10 @@ CacheMemory::addressToCacheSet(Addr address) const
 int
 CacheMemory::findTagInSet(int64_t cacheSet, Addr tag) const
 {
-    assert(tag == makeLineAddress(tag));
-    // search the set for the tags
-    auto it = m_tag_index.find(tag);
-    if (it != m_tag_index.end())
-        if (m_cache[cacheSet][it->second]->m_Permission !=
-            AccessPermission_NotPresent)
-            return it->second;
+    int loc = findTagInSetIgnorePermissions(cacheSet, tag);
+    if (loc != -1 &&
+        m_cache[cacheSet][loc]->m_Permission != AccessPermission_NotPresent)
+        return loc;
     return -1; // Not found
 }
 
@@ -139,10 +137,12 @@ CacheMemory::findTagInSetIgnorePermissions(int64_t cacheSet,
                                            Addr tag) const
 {
     assert(tag == makeLineAddress(tag));
-    // search the set for the tags
-    auto it = m_tag_index.find(tag);
-    if (it != m_tag_index.end())
-        return it->second;
+    // search the set for the tag, allocate keeps it in one way at most
+    const Addr *tags = &m_tags[cacheSet * m_cache_assoc];
+    for (int i = 0; i < m_cache_assoc; i++) {
+        if (tags[i] == tag)
+            return i;
+    }
     return -1; // Not found
 }
 
@@ -271,8 +271,14 @@ CacheMemory::allocate(Addr address, AbstractCacheEntry *entry)
     assert(cacheAvail(address));
     DPRINTF(RubyCache, "address: %#x\n", address);
 
-    // Find the first open slot
+    // A NotPresent entry left behind by the protocol may still hold the
+    // tag in another way: drop it so that the tag maps to the new entry
     int64_t cacheSet = addressToCacheSet(address);
+    int stale = findTagInSetIgnorePermissions(cacheSet, address);
+    if (stale != -1)
+        m_tags[cacheSet * m_cache_assoc + stale] = MaxAddr;
+
+    // Find the first open slot
     std::vector<AbstractCacheEntry*> &set = m_cache[cacheSet];
     for (int i = 0; i < m_cache_assoc; i++) {
         if (!set[i] || set[i]->m_Permission == AccessPermission_NotPresent) {
@@ -289,7 +295,7 @@ CacheMemory::allocate(Addr address, AbstractCacheEntry *entry)
             DPRINTF(RubyCache, "Allocate clearing lock for addr: %x\n",
                     address);
             set[i]->m_locked = -1;
-            m_tag_index[address] = i;
+            m_tags[cacheSet * m_cache_assoc + i] = address;
             set[i]->setPosition(cacheSet, i);
             // Call reset function here to set initial value for different
             // replacement policies.
@@ -313,7 +319,7 @@ CacheMemory::deallocate(Addr address)
         m_replacementPolicy_ptr->invalidate(replacement_data[cacheSet][loc]);
         delete m_cache[cacheSet][loc];
         m_cache[cacheSet][loc] = NULL;
-        m_tag_index.erase(address);
+        m_tags[cacheSet * m_cache_assoc + loc] = MaxAddr;
     }
 }
 
@@ -167,9 +167,16 @@ class CacheMemory : public SimObject
 
     // The first index is the # of cache lines.
     // The second index is the the amount associativity.
-    std::unordered_map<Addr, int> m_tag_index;
     std::vector<std::vector<AbstractCacheEntry*> > m_cache;
 
+    /**
+     * Line address held by each block, MaxAddr if none, stored set after
+     * set (the ways of set s start at s * m_cache_assoc). Looking a tag up
+     * scans the few contiguous tags of its set rather than hashing the
+     * address and following an entry pointer for every way.
+     */
+    std::vector<Addr> m_tags;
+
     /**
      * We use BaseReplacementPolicy from Classic system here, hence we can use
      * different replacement policies from Classic system in Ruby system.
@@ -920,24 +920,20 @@ GPUCoalescer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
             accessMask[tmpOffset + j] = true;
         }
     }
-    std::shared_ptr<RubyRequest> msg;
+    RefCountingPtr<RubyRequest> msg;
     if (pkt->isAtomicOp()) {
-        msg = std::make_shared<RubyRequest>(clockEdge(), pkt->getAddr(),
-                              pkt->getPtr<uint8_t>(),
-                              pkt->getSize(), pc, secondary_type,
-                              RubyAccessMode_Supervisor, pkt,
-                              PrefetchBit_No, proc_id, 100,
-                              blockSize, accessMask,
-                              dataBlock, atomicOps,
+        msg = new RubyRequest(clockEdge(), pkt->getAddr(),
+                              pkt->getPtr<uint8_t>(), pkt->getSize(), pc,
+                              secondary_type, RubyAccessMode_Supervisor,
+                              pkt, PrefetchBit_No, proc_id, 100, blockSize,
+                              accessMask, dataBlock, atomicOps,
                               accessScope, accessSegment);
     } else {
-        msg = std::make_shared<RubyRequest>(clockEdge(), pkt->getAddr(),
-                              pkt->getPtr<uint8_t>(),
-                              pkt->getSize(), pc, secondary_type,
-                              RubyAccessMode_Supervisor, pkt,
-                              PrefetchBit_No, proc_id, 100,
-                              blockSize, accessMask,
-                              dataBlock,
+        msg = new RubyRequest(clockEdge(), pkt->getAddr(),
+                              pkt->getPtr<uint8_t>(), pkt->getSize(), pc,
+                              secondary_type, RubyAccessMode_Supervisor,
+                              pkt, PrefetchBit_No, proc_id, 100, blockSize,
+                              accessMask, dataBlock,
                               accessScope, accessSegment);
     }
     DPRINTFR(ProtocolTrace, "%15s %3s %10s%20s %6s>%-6s %s %s\n",
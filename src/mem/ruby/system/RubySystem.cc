@@ -40,6 +40,7 @@
 #include "debug/RubySystem.hh"
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/network/Network.hh"
+#include "mem/ruby/protocol/MachineType.hh"
 #include "mem/simple_mem.hh"
 #include "sim/eventq.hh"
 #include "sim/simulate.hh"
@@ -328,6 +329,20 @@ RubySystem::unserialize(CheckpointIn &cp)
     makeCacheRecorder(uncompressed_trace, cache_trace_size, block_size_bytes);
 }
 
+void
+RubySystem::init()
+{
+    // A NetDest has room for NUMBER_BITS_PER_SET controllers of each
+    // machine type, and only asserts on the controllers it is given
+    for (MachineType m = MachineType_FIRST; m < MachineType_NUM; ++m) {
+        fatal_if(MachineType_base_count(m) > NUMBER_BITS_PER_SET,
+                 "Number of bits(%d) < number of %s controllers(%d). "
+                 "Increase the number of bits and recompile.\n",
+                 NUMBER_BITS_PER_SET, MachineType_to_string(m),
+                 MachineType_base_count(m));
+    }
+}
+
 void
 RubySystem::startup()
 {
@@ -86,6 +86,7 @@ class RubySystem : public ClockedObject
     void unserialize(CheckpointIn &cp) override;
     void drainResume() override;
     void process();
+    void init() override;
     void startup() override;
     bool functionalRead(Packet *ptr);
     bool functionalWrite(Packet *ptr);
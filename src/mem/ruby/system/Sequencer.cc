@@ -30,6 +30,7 @@
 #include "mem/ruby/system/Sequencer.hh"
 
 #include "arch/x86/ldstflags.hh"
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/str.hh"
 #include "cpu/testers/rubytest/RubyTester.hh"
@@ -47,6 +48,124 @@
 
 using namespace std;
 
+SequencerRequestTable::SequencerRequestTable(int max_requests)
+    : m_slots(max_requests,
+              Slot{SequencerRequest(nullptr, RubyRequestType_NULL,
+                                    RubyRequestType_NULL, Cycles(0)), -1}),
+      m_free_slot(0), m_num_lines(0),
+      m_index_bits(ceilLog2(2 * max_requests))
+{
+    assert(max_requests > 0);
+    m_lines.resize(1 << m_index_bits, Line{MaxAddr, -1, -1, 0});
+    for (int i = 0; i < max_requests - 1; i++)
+        m_slots[i].next = i + 1;
+}
+
+int
+SequencerRequestTable::home(Addr line_addr) const
+{
+    // Fibonacci hashing, so that the block offset bits do not matter
+    return (line_addr * 0x9e3779b97f4a7c15ULL) >> (64 - m_index_bits);
+}
+
+SequencerRequestTable::Line *
+SequencerRequestTable::find(Addr line_addr)
+{
+    int mask = m_lines.size() - 1;
+    for (int i = home(line_addr); m_lines[i].addr != MaxAddr;
+         i = (i + 1) & mask) {
+        if (m_lines[i].addr == line_addr)
+            return &m_lines[i];
+    }
+    return nullptr;
+}
+
+SequencerRequestTable::Line &
+SequencerRequestTable::insert(Addr line_addr,
+                              const SequencerRequest &request)
+{
+    assert(line_addr != MaxAddr);
+    panic_if(m_free_slot == -1, "More than %d outstanding requests\n",
+             m_slots.size());
+
+    int slot = m_free_slot;
+    m_free_slot = m_slots[slot].next;
+    m_slots[slot].request = request;
+    m_slots[slot].next = -1;
+
+    Line *line = find(line_addr);
+    if (!line) {
+        // There are more entries than slots, so a free one is found
+        int mask = m_lines.size() - 1;
+        int i = home(line_addr);
+        while (m_lines[i].addr != MaxAddr)
+            i = (i + 1) & mask;
+        line = &m_lines[i];
+        *line = Line{line_addr, -1, -1, 0};
+        m_num_lines++;
+    }
+
+    if (line->empty())
+        line->head = slot;
+    else
+        m_slots[line->tail].next = slot;
+    line->tail = slot;
+    line->count++;
+
+    return *line;
+}
+
+void
+SequencerRequestTable::popFront(Line &line)
+{
+    assert(!line.empty());
+    int slot = line.head;
+    line.head = m_slots[slot].next;
+    if (--line.count == 0)
+        line.tail = -1;
+
+    m_slots[slot].next = m_free_slot;
+    m_free_slot = slot;
+}
+
+void
+SequencerRequestTable::erase(Line &line)
+{
+    assert(line.empty() && line.addr != MaxAddr);
+
+    // Backward shift deletion: pull up any later entry of the probe
+    // sequence that can no longer be reached across the hole.
+    int mask = m_lines.size() - 1;
+    int hole = &line - &m_lines[0];
+    for (int i = (hole + 1) & mask; m_lines[i].addr != MaxAddr;
+         i = (i + 1) & mask) {
+        int dist_from_home = (i - home(m_lines[i].addr)) & mask;
+        if (dist_from_home >= ((i - hole) & mask)) {
+            m_lines[hole] = m_lines[i];
+            hole = i;
+        }
+    }
+    m_lines[hole] = Line{MaxAddr, -1, -1, 0};
+    m_num_lines--;
+}
+
+std::ostream &
+operator<<(ostream &out, const SequencerRequestTable &table)
+{
+    Addr last_addr = MaxAddr;
+    table.forEach([&](const SequencerRequestTable::Line &line,
+                      const SequencerRequest &seq_req) {
+        if (line.addr != last_addr) {
+            out << "[ " << line.addr << " =";
+            last_addr = line.addr;
+        }
+        out << " " << RubyRequestType_to_string(seq_req.m_second_type);
+    });
+    out << " ]";
+
+    return out;
+}
+
 Sequencer *
 RubySequencerParams::create()
 {
@@ -54,7 +173,8 @@ RubySequencerParams::create()
 }
 
 Sequencer::Sequencer(const Params *p)
-    : RubyPort(p), m_IncompleteTimes(MachineType_NUM),
+    : RubyPort(p), m_RequestTable(p->max_outstanding_requests),
+      m_IncompleteTimes(MachineType_NUM),
       deadlockCheckEvent([this]{ wakeup(); }, "Sequencer deadlock check")
 {
     m_outstanding_count = 0;
@@ -88,21 +208,20 @@ Sequencer::wakeup()
     // Check across all outstanding requests
     int total_outstanding = 0;
 
-    for (const auto &table_entry : m_RequestTable) {
-        for (const auto seq_req : table_entry.second) {
-            if (current_time - seq_req.issue_time < m_deadlock_threshold)
-                continue;
-
-            panic("Possible Deadlock detected. Aborting!\n version: %d "
-                  "request.paddr: 0x%x m_readRequestTable: %d current time: "
-                  "%u issue_time: %d difference: %d\n", m_version,
-                  seq_req.pkt->getAddr(), table_entry.second.size(),
-                  current_time * clockPeriod(), seq_req.issue_time
-                  * clockPeriod(), (current_time * clockPeriod())
-                  - (seq_req.issue_time * clockPeriod()));
-        }
-        total_outstanding += table_entry.second.size();
-    }
+    m_RequestTable.forEach([&](const SequencerRequestTable::Line &line,
+                               const SequencerRequest &seq_req) {
+        total_outstanding++;
+        if (current_time - seq_req.issue_time < m_deadlock_threshold)
+            return;
+
+        panic("Possible Deadlock detected. Aborting!\n version: %d "
+              "request.paddr: 0x%x m_readRequestTable: %d current time: "
+              "%u issue_time: %d difference: %d\n", m_version,
+              seq_req.pkt->getAddr(), line.size(),
+              current_time * clockPeriod(), seq_req.issue_time
+              * clockPeriod(), (current_time * clockPeriod())
+              - (seq_req.issue_time * clockPeriod()));
+    });
 
     assert(m_outstanding_count == total_outstanding);
 
@@ -154,9 +273,8 @@ Sequencer::insertRequest(PacketPtr pkt, RubyRequestType primary_type,
 
     Addr line_addr = makeLineAddress(pkt->getAddr());
     // Check if there is any outstanding request for the same cache line.
-    auto &seq_req_list = m_RequestTable[line_addr];
-    // Create a default entry
-    seq_req_list.emplace_back(pkt, primary_type, secondary_type, curCycle());
+    auto &seq_req_list = m_RequestTable.insert(line_addr,
+        SequencerRequest(pkt, primary_type, secondary_type, curCycle()));
     m_outstanding_count++;
 
     if (seq_req_list.size() > 1) {
@@ -308,8 +426,8 @@ Sequencer::writeCallback(Addr address, DataBlock& data,
     // to this cache line when response for the write comes back
     //
     assert(address == makeLineAddress(address));
-    assert(m_RequestTable.find(address) != m_RequestTable.end());
-    auto &seq_req_list = m_RequestTable[address];
+    assert(m_RequestTable.find(address) != nullptr);
+    auto &seq_req_list = *m_RequestTable.find(address);
 
     // Perform hitCallback on every cpu request made to this cache block while
     // ruby request was outstanding. Since only 1 ruby request was made,
@@ -318,7 +436,7 @@ Sequencer::writeCallback(Addr address, DataBlock& data,
     int aliased_stores = 0;
     int aliased_loads = 0;
     while (!seq_req_list.empty()) {
-        SequencerRequest &seq_req = seq_req_list.front();
+        SequencerRequest &seq_req = m_RequestTable.front(seq_req_list);
         if (ruby_request) {
             assert(seq_req.m_type != RubyRequestType_LD);
             assert(seq_req.m_type != RubyRequestType_IFETCH);
@@ -370,14 +488,14 @@ Sequencer::writeCallback(Addr address, DataBlock& data,
                         initialRequestTime, forwardRequestTime,
                         firstResponseTime);
         }
-        seq_req_list.pop_front();
+        m_RequestTable.popFront(seq_req_list);
         markRemoved();
         ruby_request = false;
     }
 
     // free all outstanding requests corresponding to this address
     if (seq_req_list.empty()) {
-        m_RequestTable.erase(address);
+        m_RequestTable.erase(seq_req_list);
     }
 }
 
@@ -393,8 +511,8 @@ Sequencer::readCallback(Addr address, DataBlock& data,
     // or end of the corresponding list.
     //
     assert(address == makeLineAddress(address));
-    assert(m_RequestTable.find(address) != m_RequestTable.end());
-    auto &seq_req_list = m_RequestTable[address];
+    assert(m_RequestTable.find(address) != nullptr);
+    auto &seq_req_list = *m_RequestTable.find(address);
 
     // Perform hitCallback on every cpu request made to this cache block while
     // ruby request was outstanding. Since only 1 ruby request was made,
@@ -402,7 +520,7 @@ Sequencer::readCallback(Addr address, DataBlock& data,
     bool ruby_request = true;
     int aliased_loads = 0;
     while (!seq_req_list.empty()) {
-        SequencerRequest &seq_req = seq_req_list.front();
+        SequencerRequest &seq_req = m_RequestTable.front(seq_req_list);
         if (ruby_request) {
             assert((seq_req.m_type == RubyRequestType_LD) ||
                    (seq_req.m_type == RubyRequestType_IFETCH));
@@ -423,14 +541,14 @@ Sequencer::readCallback(Addr address, DataBlock& data,
         hitCallback(&seq_req, data, true, mach, externalHit,
                     initialRequestTime, forwardRequestTime,
                     firstResponseTime);
-        seq_req_list.pop_front();
+        m_RequestTable.popFront(seq_req_list);
         markRemoved();
         ruby_request = false;
     }
 
     // free all outstanding requests corresponding to this address
     if (seq_req_list.empty()) {
-        m_RequestTable.erase(address);
+        m_RequestTable.erase(seq_req_list);
     }
 }
 
@@ -632,13 +750,13 @@ Sequencer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
 
     // check if the packet has data as for example prefetch and flush
     // requests do not
-    std::shared_ptr<RubyRequest> msg =
-        std::make_shared<RubyRequest>(clockEdge(), pkt->getAddr(),
-                                      pkt->isFlush() ?
-                                      nullptr : pkt->getPtr<uint8_t>(),
-                                      pkt->getSize(), pc, secondary_type,
-                                      RubyAccessMode_Supervisor, pkt,
-                                      PrefetchBit_No, proc_id, core_id);
+    RefCountingPtr<RubyRequest> msg =
+        new RubyRequest(clockEdge(), pkt->getAddr(),
+                        pkt->isFlush() ?
+                        nullptr : pkt->getPtr<uint8_t>(),
+                        pkt->getSize(), pc, secondary_type,
+                        RubyAccessMode_Supervisor, pkt,
+                        PrefetchBit_No, proc_id, core_id);
 
     DPRINTFR(ProtocolTrace, "%15s %3s %10s%20s %6s>%-6s %#x %s\n",
             curTick(), m_version, "Seq", "Begin", "", "",
@@ -653,21 +771,6 @@ Sequencer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
     m_mandatory_q_ptr->enqueue(msg, clockEdge(), latency);
 }
 
-template <class KEY, class VALUE>
-std::ostream &
-operator<<(ostream &out, const std::unordered_map<KEY, VALUE> &map)
-{
-    for (const auto &table_entry : map) {
-        out << "[ " << table_entry.first << " =";
-        for (const auto &seq_req : table_entry.second) {
-            out << " " << RubyRequestType_to_string(seq_req.m_second_type);
-        }
-    }
-    out << " ]";
-
-    return out;
-}
-
 void
 Sequencer::print(ostream& out) const
 {
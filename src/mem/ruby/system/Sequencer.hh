@@ -30,8 +30,7 @@
 #define __MEM_RUBY_SYSTEM_SEQUENCER_HH__
 
 #include <iostream>
-#include <list>
-#include <unordered_map>
+#include <vector>
 
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/protocol/MachineType.hh"
@@ -56,6 +55,78 @@ struct SequencerRequest
 
 std::ostream& operator<<(std::ostream& out, const SequencerRequest& obj);
 
+/**
+ * The requests outstanding in a sequencer, by cache line. No more than
+ * max_outstanding_requests requests are ever in flight, so they are kept
+ * in a fixed pool of slots chained in arrival order for each line, and the
+ * lines are found in an open-addressed (linear probing) table of at least
+ * twice as many entries. Nothing is allocated once the table is built,
+ * and an entry stays where it is until it is erased.
+ */
+class SequencerRequestTable
+{
+  public:
+    // The requests outstanding for a line, oldest first
+    struct Line
+    {
+        Addr addr;
+        int head;
+        int tail;
+        int count;
+
+        bool empty() const { return count == 0; }
+        int size() const { return count; }
+    };
+
+    SequencerRequestTable(int max_requests);
+
+    bool empty() const { return m_num_lines == 0; }
+
+    // The entry of a line, or nullptr if it has no request outstanding
+    Line *find(Addr line_addr);
+
+    // Queue a request behind the ones already outstanding for its line
+    Line &insert(Addr line_addr, const SequencerRequest &request);
+
+    SequencerRequest &front(const Line &line)
+    { return m_slots[line.head].request; }
+    void popFront(Line &line);
+
+    // Remove the entry of a line that has no request left
+    void erase(Line &line);
+
+    // Visit every outstanding request, line by line, oldest first
+    template <class Visitor>
+    void
+    forEach(Visitor visit) const
+    {
+        for (const Line &line : m_lines) {
+            if (line.addr == MaxAddr)
+                continue;
+            for (int s = line.head; s != -1; s = m_slots[s].next)
+                visit(line, m_slots[s].request);
+        }
+    }
+
+  private:
+    struct Slot
+    {
+        SequencerRequest request;
+        // Next request of the same line, or next free slot
+        int next;
+    };
+
+    int home(Addr line_addr) const;
+
+    std::vector<Line> m_lines;
+    std::vector<Slot> m_slots;
+    int m_free_slot;
+    int m_num_lines;
+    int m_index_bits;
+};
+
+std::ostream& operator<<(std::ostream& out, const SequencerRequestTable& obj);
+
 class Sequencer : public RubyPort
 {
   public:
@@ -189,7 +260,7 @@ class Sequencer : public RubyPort
     Cycles m_inst_cache_hit_latency;
 
     // RequestTable contains both read and write requests, handles aliasing
-    std::unordered_map<Addr, std::list<SequencerRequest>> m_RequestTable;
+    SequencerRequestTable m_RequestTable;
 
     // Global outstanding request count, across all request tables
     int m_outstanding_count;
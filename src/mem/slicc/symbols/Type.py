@@ -213,6 +213,11 @@ class Type(Symbol):
             code('#include "mem/ruby/protocol/$0.hh"', self["interface"])
             parent = " :  public %s" % self["interface"]
 
+        if self.isMessage:
+            # Messages are allocated from per-type pools
+            code('#include "mem/ruby/common/ObjectPool.hh"')
+            parent += ", public PooledObject<%s>" % self.c_ident
+
         code('''
 $klass ${{self.c_ident}}$parent
 {
@@ -291,7 +296,7 @@ $klass ${{self.c_ident}}$parent
 MsgPtr
 clone() const
 {
-     return std::shared_ptr<Message>(new ${{self.c_ident}}(*this));
+     return MsgPtr(new ${{self.c_ident}}(*this));
 }
 ''')
         else:
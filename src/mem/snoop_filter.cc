@@ -52,7 +52,7 @@
 const int SnoopFilter::SNOOP_MASK_SIZE;
 
 void
-SnoopFilter::eraseIfNullEntry(SnoopFilterCache::iterator& sf_it)
+SnoopFilter::eraseIfNullEntry(SnoopFilterCache::Entry* sf_it)
 {
     SnoopItem& sf_item = sf_it->second;
     if ((sf_item.requested | sf_item.holder).none()) {
@@ -62,7 +62,7 @@ SnoopFilter::eraseIfNullEntry(SnoopFilterCache::iterator& sf_it)
     }
 }
 
-std::pair<SnoopFilter::SnoopList, Cycles>
+std::pair<SnoopFilter::SnoopTargets, Cycles>
 SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
 {
     DPRINTF(SnoopFilter, "%s: src %s packet %s\n", __func__,
@@ -77,7 +77,7 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
     }
     SnoopMask req_port = portToMask(slave_port);
     reqLookupResult.it = cachedLocations.find(line_addr);
-    bool is_hit = (reqLookupResult.it != cachedLocations.end());
+    bool is_hit = (reqLookupResult.it != nullptr);
 
     // If the snoop filter has no entry, and we should not allocate,
     // do not create a new snoop filter entry, simply return a NULL
@@ -87,8 +87,7 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
 
     // If no hit in snoop filter create a new element and update iterator
     if (!is_hit) {
-        reqLookupResult.it =
-            cachedLocations.emplace(line_addr, SnoopItem()).first;
+        reqLookupResult.it = cachedLocations.insert(line_addr).first;
     }
     SnoopItem& sf_item = reqLookupResult.it->second;
     SnoopMask interested = sf_item.holder | sf_item.requested;
@@ -111,8 +110,7 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
 
     // If we are not allocating, we are done
     if (!allocate)
-        return snoopSelected(maskToPortList(interested & ~req_port),
-                             lookupLatency);
+        return snoopSelected(interested & ~req_port, lookupLatency);
 
     if (cpkt->needsResponse()) {
         if (!cpkt->cacheResponding()) {
@@ -151,13 +149,13 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
         }
     }
 
-    return snoopSelected(maskToPortList(interested & ~req_port), lookupLatency);
+    return snoopSelected(interested & ~req_port, lookupLatency);
 }
 
 void
 SnoopFilter::finishRequest(bool will_retry, Addr addr, bool is_secure)
 {
-    if (reqLookupResult.it != cachedLocations.end()) {
+    if (reqLookupResult.it != nullptr) {
         // since we rely on the caller, do a basic check to ensure
         // that finishRequest is being called following lookupRequest
         Addr line_addr = (addr & ~(Addr(linesize - 1)));
@@ -180,7 +178,7 @@ SnoopFilter::finishRequest(bool will_retry, Addr addr, bool is_secure)
     }
 }
 
-std::pair<SnoopFilter::SnoopList, Cycles>
+std::pair<SnoopFilter::SnoopTargets, Cycles>
 SnoopFilter::lookupSnoop(const Packet* cpkt)
 {
     DPRINTF(SnoopFilter, "%s: packet %s\n", __func__, cpkt->print());
@@ -192,7 +190,7 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
         line_addr |= LineSecure;
     }
     auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = (sf_it != cachedLocations.end());
+    bool is_hit = (sf_it != nullptr);
 
     panic_if(!is_hit && (cachedLocations.size() >= maxEntryCount),
              "snoop filter exceeded capacity of %d cache blocks\n",
@@ -237,7 +235,7 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
         eraseIfNullEntry(sf_it);
     }
 
-    return snoopSelected(maskToPortList(interested), lookupLatency);
+    return snoopSelected(interested, lookupLatency);
 }
 
 void
@@ -264,7 +262,14 @@ SnoopFilter::updateSnoopResponse(const Packet* cpkt,
     }
     SnoopMask rsp_mask = portToMask(rsp_port);
     SnoopMask req_mask = portToMask(req_port);
-    SnoopItem& sf_item = cachedLocations[line_addr];
+    auto sf_it = cachedLocations.find(line_addr);
+
+    // The destination should have had a request in, and the request
+    // allocated the entry
+    panic_if(sf_it == nullptr, "No SF entry for snoop response to %#llx\n",
+             line_addr);
+
+    SnoopItem& sf_item = sf_it->second;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -312,7 +317,7 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
         line_addr |= LineSecure;
     }
     auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = sf_it != cachedLocations.end();
+    bool is_hit = sf_it != nullptr;
 
     // Nothing to do if it is not a hit
     if (!is_hit)
@@ -353,7 +358,7 @@ SnoopFilter::updateResponse(const Packet* cpkt, const SlavePort& slave_port)
         line_addr |= LineSecure;
     }
     auto sf_it = cachedLocations.find(line_addr);
-    if (sf_it == cachedLocations.end())
+    if (sf_it == nullptr)
         return;
 
     SnoopMask slave_mask = portToMask(slave_port);
@@ -46,12 +46,12 @@
 #define __MEM_SNOOP_FILTER_HH__
 
 #include <bitset>
-#include <unordered_map>
 #include <utility>
 
 #include "mem/packet.hh"
 #include "mem/port.hh"
 #include "mem/qport.hh"
+#include "mem/snoop_filter_table.hh"
 #include "params/SnoopFilter.hh"
 #include "sim/sim_object.hh"
 #include "sim/system.hh"
@@ -93,11 +93,121 @@ class SnoopFilter : public SimObject {
 
     typedef std::vector<QueuedSlavePort*> SnoopList;
 
+    /**
+     * The underlying type for the bitmask we use for tracking. This
+     * limits the number of snooping ports supported per crossbar.
+     */
+    typedef std::bitset<SNOOP_MASK_SIZE> SnoopMask;
+
+    /**
+     * The ports to snoop as the result of a lookup. Rather than a
+     * list of its own, this is a view of a list of ports, either all
+     * of them or those selected by a mask, so that lookups do not
+     * allocate. The list of ports must outlive the view.
+     */
+    class SnoopTargets
+    {
+      public:
+
+        class const_iterator
+        {
+          public:
+            const_iterator(const SnoopTargets& _targets, size_t _idx)
+                : targets(&_targets), idx(_idx)
+            {
+                skip();
+            }
+
+            QueuedSlavePort* operator*() const
+            {
+                return (*targets->ports)[idx];
+            }
+
+            const_iterator&
+            operator++()
+            {
+                ++idx;
+                skip();
+                return *this;
+            }
+
+            bool operator==(const const_iterator& other) const
+            {
+                return idx == other.idx;
+            }
+
+            bool operator!=(const const_iterator& other) const
+            {
+                return idx != other.idx;
+            }
+
+          private:
+
+            /** Move on to the next selected port, if not on one */
+            void
+            skip()
+            {
+                while (idx < targets->ports->size() &&
+                       !targets->selected(idx))
+                    ++idx;
+            }
+
+            const SnoopTargets* targets;
+            size_t idx;
+        };
+
+        /**
+         * Select all the ports of a list.
+         *
+         * @param _ports List of ports
+         */
+        explicit SnoopTargets(const SnoopList& _ports)
+            : ports(&_ports), mask(), all(true)
+        {
+        }
+
+        /**
+         * Select the ports of a list set in a mask.
+         *
+         * @param _ports List of ports
+         * @param _mask Mask indexed by the position of the port in the list
+         */
+        SnoopTargets(const SnoopList& _ports, const SnoopMask& _mask)
+            : ports(&_ports), mask(_mask), all(false)
+        {
+        }
+
+        const_iterator begin() const { return const_iterator(*this, 0); }
+
+        const_iterator
+        end() const
+        {
+            return const_iterator(*this, ports->size());
+        }
+
+        size_t size() const { return all ? ports->size() : mask.count(); }
+
+        bool empty() const { return size() == 0; }
+
+      private:
+
+        bool selected(size_t idx) const { return all || mask[idx]; }
+
+        const SnoopList* ports;
+        SnoopMask mask;
+        bool all;
+    };
+
     SnoopFilter (const SnoopFilterParams *p) :
-        SimObject(p), reqLookupResult(cachedLocations.end()),
+        SimObject(p),
+        cachedLocations(p->system->cacheLineSize(), p->region_size),
         linesize(p->system->cacheLineSize()), lookupLatency(p->lookup_latency),
         maxEntryCount(p->max_capacity / p->system->cacheLineSize())
     {
+        fatal_if(!isPowerOf2(p->region_size) ||
+                 p->region_size < linesize,
+                 "Snoop filter region size %d must be a power of two of at "
+                 "least a cache line\n", p->region_size);
     }
 
     /**
@@ -134,9 +244,9 @@ class SnoopFilter : public SimObject {
      *
      * @param cpkt          Pointer to the request packet. Not changed.
      * @param slave_port    Slave port where the request came from.
-     * @return Pair of a vector of snoop target ports and lookup latency.
+     * @return Pair of the snoop target ports and lookup latency.
      */
-    std::pair<SnoopList, Cycles> lookupRequest(const Packet* cpkt,
+    std::pair<SnoopTargets, Cycles> lookupRequest(const Packet* cpkt,
                                                const SlavePort& slave_port);
 
     /**
@@ -156,10 +266,10 @@ class SnoopFilter : public SimObject {
      * additional steering thanks to the snoop filter.
      *
      * @param cpkt Pointer to const Packet containing the snoop.
-     * @return Pair with a vector of SlavePorts that need snooping and a lookup
+     * @return Pair with the SlavePorts that need snooping and a lookup
      *         latency.
      */
-    std::pair<SnoopList, Cycles> lookupSnoop(const Packet* cpkt);
+    std::pair<SnoopTargets, Cycles> lookupSnoop(const Packet* cpkt);
 
     /**
      * Let the snoop filter see any snoop responses that turn into
@@ -201,12 +311,6 @@ class SnoopFilter : public SimObject {
 
   protected:
 
-    /**
-     * The underlying type for the bitmask we use for tracking. This
-     * limits the number of snooping ports supported per crossbar.
-     */
-    typedef std::bitset<SNOOP_MASK_SIZE> SnoopMask;
-
     /**
     * Per cache line item tracking a bitmask of SlavePorts who have an
     * outstanding request to this line (requested) or already share a
@@ -217,26 +321,25 @@ class SnoopFilter : public SimObject {
         SnoopMask holder;
     };
     /**
-     * HashMap of SnoopItems indexed by line address
+     * Hash table of SnoopItems indexed by line address
      */
-    typedef std::unordered_map<Addr, SnoopItem> SnoopFilterCache;
+    typedef SnoopFilterTable<SnoopItem> SnoopFilterCache;
 
     /**
      * Simple factory methods for standard return values.
      */
-    std::pair<SnoopList, Cycles> snoopAll(Cycles latency) const
+    std::pair<SnoopTargets, Cycles> snoopAll(Cycles latency) const
     {
-        return std::make_pair(slavePorts, latency);
+        return std::make_pair(SnoopTargets(slavePorts), latency);
     }
-    std::pair<SnoopList, Cycles> snoopSelected(const SnoopList& slave_ports,
-                                               Cycles latency) const
+    std::pair<SnoopTargets, Cycles> snoopSelected(SnoopMask ports,
+                                                  Cycles latency) const
     {
-        return std::make_pair(slave_ports, latency);
+        return std::make_pair(SnoopTargets(slavePorts, ports), latency);
     }
-    std::pair<SnoopList, Cycles> snoopDown(Cycles latency) const
+    std::pair<SnoopTargets, Cycles> snoopDown(Cycles latency) const
     {
-        SnoopList empty;
-        return std::make_pair(empty , latency);
+        return std::make_pair(SnoopTargets(slavePorts, 0), latency);
     }
 
     /**
@@ -245,21 +348,15 @@ class SnoopFilter : public SimObject {
      * @return One-hot bitmask corresponding to the port.
      */
     SnoopMask portToMask(const SlavePort& port) const;
-    /**
-     * Converts a bitmask of ports into the corresponing list of ports
-     * @param ports SnoopMask of the requested ports
-     * @return SnoopList containing all the requested SlavePorts
-     */
-    SnoopList maskToPortList(SnoopMask ports) const;
 
   private:
 
     /**
      * Removes snoop filter items which have no requesters and no holders.
      */
-    void eraseIfNullEntry(SnoopFilterCache::iterator& sf_it);
+    void eraseIfNullEntry(SnoopFilterCache::Entry* sf_it);
 
-    /** Simple hash set of cached addresses. */
+    /** Hash table of cached addresses. */
     SnoopFilterCache cachedLocations;
 
     /**
@@ -269,8 +366,11 @@ class SnoopFilter : public SimObject {
      * This structure keeps track of the state previous to such changes.
      */
     struct ReqLookupResult {
-        /** Iterator used to store the result from lookupRequest. */
-        SnoopFilterCache::iterator it;
+        /**
+         * Entry used to store the result from lookupRequest, or nullptr
+         * if the request did not hit or allocate.
+         */
+        SnoopFilterCache::Entry* it;
 
         /**
          * Variable to temporarily store value of snoopfilter entry
@@ -279,17 +379,10 @@ class SnoopFilter : public SimObject {
          */
         SnoopItem retryItem;
 
-        /**
-         * The constructor must be informed of the internal cache's end
-         * iterator, so do not allow the compiler to implictly define it.
-         *
-         * @param end_it Iterator to the end of the internal cache.
-         */
-        ReqLookupResult(SnoopFilterCache::iterator end_it)
-            : it(end_it), retryItem{0, 0}
+        ReqLookupResult()
+            : it(nullptr), retryItem{0, 0}
         {
         }
-        ReqLookupResult() = delete;
     } reqLookupResult;
 
     /** List of all attached snooping slave ports. */
@@ -330,14 +423,4 @@ SnoopFilter::portToMask(const SlavePort& port) const
         ((SnoopMask)1) << localSlavePortIds[port.getId()];
 }
 
-inline SnoopFilter::SnoopList
-SnoopFilter::maskToPortList(SnoopMask port_mask) const
-{
-    SnoopList res;
-    for (const auto& p : slavePorts)
-        if ((port_mask & portToMask(*p)).any())
-            res.push_back(p);
-    return res;
-}
-
 #endif // __MEM_SNOOP_FILTER_HH__
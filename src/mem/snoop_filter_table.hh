@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2013-2016,2019 ARM Limited
+ * All rights reserved
+ *
+ * The license below extends only to copyright in the software and shall
+ * not be construed as granting a license to any other intellectual
+ * property including but not limited to intellectual property relating
+ * to a hardware implementation of the functionality of the software
+ * licensed hereunder.  You may use the software subject to the license
+ * terms below provided that you ensure that this notice is replicated
+ * unmodified and in its entirety in all distributions of the software,
+ * modified or unmodified, in source code or in binary form.
+ *
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: Stephan Diestelhorst
+ */
+
+/**
+ * @file
+ * Definition of the table holding the snoop filter entries.
+ */
+
+#ifndef __MEM_SNOOP_FILTER_TABLE_HH__
+#define __MEM_SNOOP_FILTER_TABLE_HH__
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "base/intmath.hh"
+#include "base/types.hh"
+
+/**
+ * An open-addressed hash table from cache line address to a snoop
+ * filter item. The entries live in a single array and are found by
+ * linear probing, so a lookup touches a few neighbouring entries
+ * rather than following the bucket and node pointers of a node-based
+ * map, and adding or removing an entry does not allocate.
+ *
+ * The lines of an aligned region are grouped: the region is hashed
+ * to pick a group of consecutive slots, and the line offset within
+ * the region picks the slot in the group. Lines touched close in
+ * time that are also close in space, as for streams of accesses,
+ * thus end up in the same host cache lines. The region can be as
+ * large as a page. Tracking stays per line whatever the region size.
+ *
+ * The keys are line addresses, possibly with flags in the line
+ * offset bits, and two addresses with all the offset bits set are
+ * reserved to mark empty and deleted slots.
+ *
+ * Pointers to entries are stable until the next insert, which may
+ * resize the table. Erasing does not move any other entry.
+ */
+template <class Item>
+class SnoopFilterTable
+{
+  public:
+
+    /** An entry maps a line address to its item */
+    typedef std::pair<Addr, Item> Entry;
+
+    /**
+     * @param line_size Size of the lines in bytes
+     * @param region_size Size of the regions grouped together in bytes
+     */
+    SnoopFilterTable(unsigned line_size, unsigned region_size)
+        : lineShift(floorLog2(line_size)),
+          regionBits(floorLog2(region_size / line_size)),
+          numEntries(0), numDeleted(0)
+    {
+        assert(isPowerOf2(line_size) && line_size >= 4);
+        assert(isPowerOf2(region_size) && region_size >= line_size);
+        resize(std::max(minSize, 2u << regionBits));
+    }
+
+    /** Number of entries in the table. */
+    size_t size() const { return numEntries; }
+
+    /** Number of slots, whether empty, deleted or holding an entry. */
+    size_t capacity() const { return slots.size(); }
+
+    /** Number of slots marked as deleted. */
+    size_t deleted() const { return numDeleted; }
+
+    /**
+     * Find the entry of a line.
+     *
+     * @param addr Line address
+     * @return The entry, or nullptr if the line has none
+     */
+    Entry*
+    find(Addr addr)
+    {
+        assert(addr != emptyKey && addr != deletedKey);
+        for (size_t i = slot(addr); ; i = (i + 1) & mask) {
+            if (slots[i].first == addr)
+                return &slots[i];
+            if (slots[i].first == emptyKey)
+                return nullptr;
+        }
+    }
+
+    /**
+     * Find the entry of a line, adding an entry with a value
+     * initialised item if there is none. This may move all the
+     * entries.
+     *
+     * @param addr Line address
+     * @return The entry, and true if it was added
+     */
+    std::pair<Entry*, bool>
+    insert(Addr addr)
+    {
+        assert(addr != emptyKey && addr != deletedKey);
+
+        // keep at least a quarter of the slots empty so that probing
+        // for a missing line stops quickly, and only grow when the
+        // entries themselves, and not the deleted slots, need it
+        if ((numEntries + numDeleted + 1) * 4 > slots.size() * 3) {
+            size_t new_size = slots.size();
+            while ((numEntries + 1) * 2 > new_size)
+                new_size *= 2;
+            resize(new_size);
+        }
+
+        Entry* reuse = nullptr;
+        for (size_t i = slot(addr); ; i = (i + 1) & mask) {
+            if (slots[i].first == addr)
+                return std::make_pair(&slots[i], false);
+            if (slots[i].first == deletedKey && !reuse) {
+                reuse = &slots[i];
+            } else if (slots[i].first == emptyKey) {
+                if (reuse) {
+                    --numDeleted;
+                } else {
+                    reuse = &slots[i];
+                }
+                break;
+            }
+        }
+
+        reuse->first = addr;
+        reuse->second = Item();
+        ++numEntries;
+        return std::make_pair(reuse, true);
+    }
+
+    /**
+     * Remove an entry. Pointers to the other entries remain valid.
+     *
+     * @param entry Entry to remove
+     */
+    void
+    erase(Entry* entry)
+    {
+        assert(entry >= slots.data() && entry < slots.data() + slots.size());
+        assert(entry->first != emptyKey && entry->first != deletedKey);
+
+        // a slot that ends a probe sequence can be made empty right
+        // away, otherwise it has to be kept as deleted for the lookups
+        // of the lines beyond it
+        size_t i = entry - slots.data();
+        if (slots[(i + 1) & mask].first == emptyKey) {
+            entry->first = emptyKey;
+        } else {
+            entry->first = deletedKey;
+            ++numDeleted;
+        }
+        --numEntries;
+    }
+
+  private:
+
+    /** Keys of the empty and deleted slots, not valid line addresses */
+    static const Addr emptyKey = MaxAddr;
+    static const Addr deletedKey = MaxAddr - 1;
+
+    /** Initial number of slots */
+    static const unsigned minSize = 1024;
+
+    /**
+     * First slot to probe for a line: the hash of its region picks a
+     * group of slots, and its offset in the region one of them.
+     */
+    size_t
+    slot(Addr addr) const
+    {
+        const Addr line = addr >> lineShift;
+        const uint64_t region = line >> regionBits;
+        const size_t group =
+            (region * 0x9e3779b97f4a7c15ULL) >> (64 - groupBits);
+        return ((group << regionBits) | (line & regionMask)) & mask;
+    }
+
+    /**
+     * Rebuild the table with a new number of slots, dropping the
+     * deleted slots.
+     *
+     * @param new_size New number of slots, a power of two
+     */
+    void
+    resize(size_t new_size)
+    {
+        assert(isPowerOf2(new_size) && new_size > (1u << regionBits));
+
+        std::vector<Entry> old_slots(new_size,
+                                     Entry(emptyKey, Item()));
+        old_slots.swap(slots);
+        mask = new_size - 1;
+        groupBits = floorLog2(new_size) - regionBits;
+        regionMask = (Addr(1) << regionBits) - 1;
+        numDeleted = 0;
+
+        for (const auto& e : old_slots) {
+            if (e.first == emptyKey || e.first == deletedKey)
+                continue;
+            size_t i = slot(e.first);
+            while (slots[i].first != emptyKey)
+                i = (i + 1) & mask;
+            slots[i] = e;
+        }
+    }
+
+    /** Number of line offset bits in the addresses */
+    const unsigned lineShift;
+
+    /** Number of bits of the line index within a region */
+    const unsigned regionBits;
+
+    /** Mask of the line index within a region */
+    Addr regionMask;
+
+    /** Number of bits of the hashed region */
+    unsigned groupBits;
+
+    /** Mask of the slot index */
+    size_t mask;
+
+    /** Number of entries */
+    size_t numEntries;
+
+    /** Number of slots marked as deleted */
+    size_t numDeleted;
+
+    /** The slots, each either empty, deleted or holding an entry */
+    std::vector<Entry> slots;
+};
+
+template <class Item>
+const Addr SnoopFilterTable<Item>::emptyKey;
+
+template <class Item>
+const Addr SnoopFilterTable<Item>::deletedKey;
+
+template <class Item>
+const unsigned SnoopFilterTable<Item>::minSize;
+
+#endif // __MEM_SNOOP_FILTER_TABLE_HH__
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "mem/snoop_filter_table.hh"
+
+namespace {
+
+struct TestItem
+{
+    int value = 0;
+};
+
+typedef SnoopFilterTable<TestItem> Table;
+
+const unsigned lineSize = 64;
+
+/** Distinct random line addresses, all in different regions */
+std::vector<Addr>
+randomLines(size_t count, unsigned region_size)
+{
+    std::mt19937_64 rng(1);
+    std::vector<Addr> lines;
+    while (lines.size() < count) {
+        Addr addr = (rng() % (1ULL << 40)) * region_size;
+        if (std::find(lines.begin(), lines.end(), addr) == lines.end())
+            lines.push_back(addr);
+    }
+    return lines;
+}
+
+} // anonymous namespace
+
+/** Testing that an entry is found once inserted, and not once erased */
+TEST(SnoopFilterTableTest, InsertFindErase)
+{
+    Table table(lineSize, 512);
+    ASSERT_EQ(table.size(), 0);
+    ASSERT_EQ(table.find(0x1000), nullptr);
+
+    auto inserted = table.insert(0x1000);
+    ASSERT_TRUE(inserted.second);
+    ASSERT_EQ(inserted.first->first, 0x1000);
+    inserted.first->second.value = 1;
+
+    auto again = table.insert(0x1000);
+    ASSERT_FALSE(again.second);
+    ASSERT_EQ(again.first, inserted.first);
+    ASSERT_EQ(again.first->second.value, 1);
+    ASSERT_EQ(table.find(0x1000), inserted.first);
+    ASSERT_EQ(table.size(), 1);
+
+    table.erase(inserted.first);
+    ASSERT_EQ(table.find(0x1000), nullptr);
+    ASSERT_EQ(table.size(), 0);
+
+    // a new entry starts from a value initialised item
+    ASSERT_EQ(table.insert(0x1000).first->second.value, 0);
+}
+
+/**
+ * Testing that erasing the last entry of a probe sequence empties its
+ * slot, and that erasing an entry followed by another one leaves a
+ * deleted slot the following entry is still found past
+ */
+TEST(SnoopFilterTableTest, EraseIntoDeletedSlot)
+{
+    // the lines of a region take consecutive slots
+    Table table(lineSize, 512);
+    auto first = table.insert(0x2000).first;
+    auto second = table.insert(0x2040).first;
+    ASSERT_EQ(second, first + 1);
+
+    table.erase(second);
+    ASSERT_EQ(table.deleted(), 0);
+    second = table.insert(0x2040).first;
+
+    table.erase(first);
+    ASSERT_EQ(table.deleted(), 1);
+    ASSERT_EQ(table.find(0x2000), nullptr);
+    ASSERT_EQ(table.find(0x2040), second);
+    ASSERT_EQ(table.size(), 1);
+}
+
+/**
+ * Testing that the entries remain found when half of them are erased,
+ * and that inserting the erased lines again reuses deleted slots
+ * rather than growing the table
+ */
+TEST(SnoopFilterTableTest, ReuseDeletedSlots)
+{
+    Table table(lineSize, lineSize);
+    const size_t capacity = table.capacity();
+    const std::vector<Addr> lines = randomLines(capacity / 2, lineSize);
+
+    for (size_t i = 0; i < lines.size(); i++)
+        table.insert(lines[i]).first->second.value = i;
+
+    for (size_t i = 0; i < lines.size(); i += 2)
+        table.erase(table.find(lines[i]));
+    const size_t deleted = table.deleted();
+    ASSERT_GT(deleted, 0);
+
+    for (size_t i = 0; i < lines.size(); i++) {
+        auto entry = table.find(lines[i]);
+        if (i % 2) {
+            ASSERT_NE(entry, nullptr);
+            ASSERT_EQ(entry->second.value, i);
+        } else {
+            ASSERT_EQ(entry, nullptr);
+        }
+    }
+
+    for (size_t i = 0; i < lines.size(); i += 2)
+        ASSERT_TRUE(table.insert(lines[i]).second);
+    ASSERT_LT(table.deleted(), deleted);
+    ASSERT_EQ(table.capacity(), capacity);
+    ASSERT_EQ(table.size(), lines.size());
+    for (auto addr : lines)
+        ASSERT_NE(table.find(addr), nullptr);
+}
+
+/**
+ * Testing that a table whose slots fill up with deleted ones is
+ * rebuilt at the same size, as the entries alone do not need more
+ */
+TEST(SnoopFilterTableTest, ResizeOnDeletedSlots)
+{
+    Table table(lineSize, lineSize);
+    const size_t capacity = table.capacity();
+    const size_t live = capacity / 4;
+    const std::vector<Addr> lines = randomLines(capacity * 4, lineSize);
+
+    // keep a sliding window of entries, erasing the oldest one for
+    // every new one
+    bool rebuilt = false;
+    for (size_t i = 0; i < lines.size(); i++) {
+        const size_t deleted = table.deleted();
+        table.insert(lines[i]);
+        if (i >= live)
+            table.erase(table.find(lines[i - live]));
+        // reusing a slot or erasing changes the count by one at most
+        if (table.deleted() + 1 < deleted)
+            rebuilt = true;
+        ASSERT_EQ(table.capacity(), capacity);
+        ASSERT_LE((table.size() + table.deleted()) * 4, capacity * 3);
+    }
+    ASSERT_TRUE(rebuilt);
+
+    ASSERT_EQ(table.size(), live);
+    for (size_t i = 0; i < lines.size(); i++)
+        ASSERT_EQ(table.find(lines[i]) != nullptr, i >= lines.size() - live);
+}
+
+/** Testing that the table grows to keep at most half of it in use */
+TEST(SnoopFilterTableTest, Grow)
+{
+    Table table(lineSize, 512);
+    const size_t capacity = table.capacity();
+    const std::vector<Addr> lines = randomLines(capacity * 2, 512);
+
+    for (auto addr : lines)
+        table.insert(addr);
+    ASSERT_GT(table.capacity(), capacity);
+    ASSERT_LE(table.size() * 2, table.capacity());
+    for (auto addr : lines)
+        ASSERT_NE(table.find(addr), nullptr);
+}
+
+/** Testing regions as small as a line and as large as a page, or more */
+TEST(SnoopFilterTableTest, RegionSizes)
+{
+    for (unsigned region_size : { lineSize, 4096u, 65536u }) {
+        Table table(lineSize, region_size);
+
+        // there are always at least two groups of slots
+        ASSERT_GE(table.capacity(), 2 * region_size / lineSize);
+
+        // every line of a few regions, and the same lines again with
+        // flags in their offset bits
+        for (Addr region = 0; region < 4; region++) {
+            for (Addr off = 0; off < region_size; off += lineSize) {
+                const Addr addr = region * region_size + off;
+                ASSERT_TRUE(table.insert(addr).second);
+                ASSERT_TRUE(table.insert(addr | 1).second);
+            }
+        }
+        const size_t lines = 4 * region_size / lineSize;
+        ASSERT_EQ(table.size(), 2 * lines);
+
+        for (Addr addr = 0; addr < 4 * region_size; addr += lineSize) {
+            ASSERT_EQ(table.find(addr)->first, addr);
+            ASSERT_EQ(table.find(addr | 1)->first, addr | 1);
+            table.erase(table.find(addr | 1));
+        }
+        ASSERT_EQ(table.size(), lines);
+        for (Addr addr = 0; addr < 4 * region_size; addr += lineSize) {
+            ASSERT_NE(table.find(addr), nullptr);
+            ASSERT_EQ(table.find(addr | 1), nullptr);
+        }
+
+        // the highest line is not mistaken for an empty or deleted slot
+        const Addr last = MaxAddr & ~Addr(lineSize - 1);
+        ASSERT_EQ(table.find(last), nullptr);
+        ASSERT_TRUE(table.insert(last).second);
+        ASSERT_EQ(table.find(last)->first, last);
+    }
+}
@@ -108,6 +108,11 @@ def parse_options():
         help="Invoke the python debugger before running the script")
     option('-p', "--path", metavar="PATH[:PATH]", action='append', split=':',
         help="Prepend PATH to the system path when invoking the script")
+    option("--event-queue", metavar="{list,calendar}",
+        choices=("list", "calendar"), default="list",
+        help="Keep pending events in a sorted list or in a calendar " \
+        "queue, which schedules faster with many pending events " \
+        "[Default: %default]")
     option('-q', "--quiet", action="count", default=0,
         help="Reduce verbosity")
     option('-v', "--verbose", action="count", default=0,
@@ -239,6 +244,7 @@ def main(*args):
     m5.options = options
 
     # Set the main event queue for the main thread.
+    event.useCalendarEventQueue(options.event_queue == "calendar")
     event.mainq = event.getEventQueue(0)
     event.setEventQueue(event.mainq)
 
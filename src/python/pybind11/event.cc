@@ -114,6 +114,8 @@ pybind_init_event(py::module &m_native)
     m.def("setEventQueue", [](EventQueue *q) { return curEventQueue(q); });
     m.def("getEventQueue", &getEventQueue,
           py::return_value_policy::reference);
+    m.def("useCalendarEventQueue",
+          [](bool enable) { useCalendarEventQueue = enable; });
 
     py::class_<EventQueue>(m, "EventQueue")
         .def("name",  [](EventQueue *eq) { return eq->name(); })
@@ -32,12 +32,14 @@
  *          Steve Raasch
  */
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "cpu/smt.hh"
@@ -59,6 +61,15 @@ uint32_t numMainEventQueues = 0;
 vector<EventQueue *> mainEventQueue;
 __thread EventQueue *_curEventQueue = NULL;
 bool inParallelMode = false;
+bool useCalendarEventQueue = false;
+
+// Smallest number of buckets of a calendar queue, and the bucket width
+// it starts with (log2, in ticks)
+static const size_t minCalendarBuckets = 16;
+static const int initialBucketShift = 10;
+
+// Number of bins near the head that the bucket width is computed from
+static const size_t calendarWidthSamples = 32;
 
 EventQueue *
 getEventQueue(uint32_t index)
@@ -116,17 +127,26 @@ Event::insertBefore(Event *event, Event *curr)
 
 void
 EventQueue::insert(Event *event)
+{
+    if (useCalendar)
+        calendarInsert(event);
+    else
+        insertInBins(head, event);
+}
+
+void
+EventQueue::insertInBins(Event *&top, Event *event)
 {
     // Deal with the head case
-    if (!head || *event <= *head) {
-        head = Event::insertBefore(event, head);
+    if (!top || *event <= *top) {
+        top = Event::insertBefore(event, top);
         return;
     }
 
     // Figure out either which 'in bin' list we are on, or where a new list
     // needs to be inserted
-    Event *prev = head;
-    Event *curr = head->nextBin;
+    Event *prev = top;
+    Event *curr = top->nextBin;
     while (curr && *curr < *event) {
         prev = curr;
         curr = curr->nextBin;
@@ -171,21 +191,30 @@ Event::removeItem(Event *event, Event *top)
 void
 EventQueue::remove(Event *event)
 {
-    if (head == NULL)
-        panic("event not found!");
-
     assert(event->queue == this);
 
-    // deal with an event on the head's 'in bin' list (event has the same
-    // time as the head)
-    if (*head == *event) {
-        head = Event::removeItem(event, head);
+    if (useCalendar)
+        calendarRemove(event);
+    else
+        removeFromBins(head, event);
+}
+
+void
+EventQueue::removeFromBins(Event *&top, Event *event)
+{
+    if (top == NULL)
+        panic("event not found!");
+
+    // deal with an event on the top's 'in bin' list (event has the same
+    // time as the top)
+    if (*top == *event) {
+        top = Event::removeItem(event, top);
         return;
     }
 
     // Find the 'in bin' list that this event belongs on
-    Event *prev = head;
-    Event *curr = head->nextBin;
+    Event *prev = top;
+    Event *curr = top->nextBin;
     while (curr && *curr < *event) {
         prev = curr;
         curr = curr->nextBin;
@@ -200,6 +229,116 @@ EventQueue::remove(Event *event)
     prev->nextBin = Event::removeItem(event, curr);
 }
 
+void
+EventQueue::calendarInsert(Event *event)
+{
+    insertInBins(calendar[bucketOf(event->when())], event);
+    numEvents++;
+
+    // an inserted event is always the top of its bin
+    if (!head || *event <= *head)
+        head = event;
+
+    if (numEvents > 2 * calendar.size())
+        fillCalendar(sortedBins(), 2 * calendar.size());
+}
+
+void
+EventQueue::calendarRemove(Event *event)
+{
+    removeFromBins(calendar[bucketOf(event->when())], event);
+    numEvents--;
+
+    if (event == head)
+        head = calendarHead(event->when());
+
+    if (calendar.size() > minCalendarBuckets &&
+        numEvents < calendar.size() / 2) {
+        fillCalendar(sortedBins(), calendar.size() / 2);
+    }
+}
+
+Event *
+EventQueue::calendarHead(Tick from) const
+{
+    if (numEvents == 0)
+        return NULL;
+
+    // The first bin of a bucket is the earliest event if it falls in
+    // the year being looked at; otherwise it belongs to a later year
+    size_t num_buckets = calendar.size();
+    Tick window = from >> bucketShift;
+    for (size_t i = 0; i < num_buckets; i++, window++) {
+        Event *top = calendar[window & (num_buckets - 1)];
+        if (top && (top->when() >> bucketShift) == window)
+            return top;
+    }
+
+    // Nothing this year, look at the first bin of every bucket
+    Event *earliest = NULL;
+    for (Event *top : calendar) {
+        if (top && (!earliest || *top < *earliest))
+            earliest = top;
+    }
+    return earliest;
+}
+
+void
+EventQueue::fillCalendar(const vector<Event *> &bins, size_t num_buckets)
+{
+    assert(isPowerOf2(num_buckets));
+
+    // Make a bucket two to four times the average spacing of the bins
+    // near the head, so the next few bins are found in the first
+    // buckets visited
+    size_t samples = min(bins.size(), calendarWidthSamples);
+    if (samples > 1) {
+        Tick spacing = (bins[samples - 1]->when() - bins[0]->when()) /
+            (samples - 1);
+        bucketShift = spacing > 0 ? min(ceilLog2(spacing) + 1, 63) : 0;
+    }
+
+    // The bins are sorted, so appending each one to its bucket keeps
+    // the buckets sorted too
+    calendar.assign(num_buckets, NULL);
+    vector<Event *> last(num_buckets, NULL);
+    numEvents = 0;
+    for (Event *bin : bins) {
+        size_t bucket = bucketOf(bin->when());
+        bin->nextBin = NULL;
+        if (last[bucket])
+            last[bucket]->nextBin = bin;
+        else
+            calendar[bucket] = bin;
+        last[bucket] = bin;
+
+        for (Event *e = bin; e; e = e->nextInBin)
+            numEvents++;
+    }
+
+    head = bins.empty() ? NULL : bins.front();
+}
+
+vector<Event *>
+EventQueue::sortedBins() const
+{
+    vector<Event *> bins;
+    if (!useCalendar) {
+        for (Event *bin = head; bin; bin = bin->nextBin)
+            bins.push_back(bin);
+        return bins;
+    }
+
+    bins.reserve(numEvents);
+    for (Event *top : calendar) {
+        for (Event *bin = top; bin; bin = bin->nextBin)
+            bins.push_back(bin);
+    }
+    sort(bins.begin(), bins.end(),
+         [](const Event *l, const Event *r) { return *l < *r; });
+    return bins;
+}
+
 Event *
 EventQueue::serviceOne()
 {
@@ -208,7 +347,9 @@ EventQueue::serviceOne()
     Event *next = head->nextInBin;
     event->flags.clear(Event::Scheduled);
 
-    if (next) {
+    if (useCalendar) {
+        calendarRemove(event);
+    } else if (next) {
         // update the next bin pointer since it could be stale
         next->nextBin = head->nextBin;
 
@@ -300,15 +441,12 @@ EventQueue::dump() const
     if (empty())
         cprintf("<No Events>\n");
     else {
-        Event *nextBin = head;
-        while (nextBin) {
+        for (Event *nextBin : sortedBins()) {
             Event *nextInBin = nextBin;
             while (nextInBin) {
                 nextInBin->dump();
                 nextInBin = nextInBin->nextInBin;
             }
-
-            nextBin = nextBin->nextBin;
         }
     }
 
@@ -323,8 +461,7 @@ EventQueue::debugVerify() const
     Tick time = 0;
     short priority = 0;
 
-    Event *nextBin = head;
-    while (nextBin) {
+    for (Event *nextBin : sortedBins()) {
         Event *nextInBin = nextBin;
         while (nextInBin) {
             if (nextInBin->when() < time) {
@@ -350,8 +487,6 @@ EventQueue::debugVerify() const
 
             nextInBin = nextInBin->nextInBin;
         }
-
-        nextBin = nextBin->nextBin;
     }
 
     return true;
@@ -360,8 +495,25 @@ EventQueue::debugVerify() const
 Event*
 EventQueue::replaceHead(Event* s)
 {
-    Event* t = head;
-    head = s;
+    if (!useCalendar) {
+        Event* t = head;
+        head = s;
+        return t;
+    }
+
+    // Hand out the events as a single list of bins, and take in those
+    // of s the same way
+    vector<Event *> bins = sortedBins();
+    for (size_t i = 0; i + 1 < bins.size(); i++)
+        bins[i]->nextBin = bins[i + 1];
+    if (!bins.empty())
+        bins.back()->nextBin = NULL;
+    Event* t = bins.empty() ? NULL : bins.front();
+
+    bins.clear();
+    for (Event *bin = s; bin; bin = bin->nextBin)
+        bins.push_back(bin);
+    fillCalendar(bins, calendar.size());
     return t;
 }
 
@@ -414,8 +566,12 @@ Event::dump() const
 }
 
 EventQueue::EventQueue(const string &n)
-    : objName(n), head(NULL), _curTick(0)
+    : objName(n), head(NULL), _curTick(0),
+      useCalendar(useCalendarEventQueue), bucketShift(initialBucketShift),
+      numEvents(0)
 {
+    if (useCalendar)
+        calendar.assign(minCalendarBuckets, NULL);
 }
 
 void
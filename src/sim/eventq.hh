@@ -46,6 +46,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "base/flags.hh"
 #include "base/types.hh"
@@ -76,6 +77,10 @@ extern __thread EventQueue *_curEventQueue;
 //! Current mode of execution: parallel / serial
 extern bool inParallelMode;
 
+//! Keep the events of the event queues created from now on in a
+//! calendar queue rather than in a single sorted list of bins.
+extern bool useCalendarEventQueue;
+
 //! Function for returning eventq queue for the provided
 //! index. The function allocates a new queue in case one
 //! does not exist for the index, provided that the index
@@ -199,7 +204,8 @@ class Event : public EventBase, public Serializable
     // result is that the insert/removal in 'nextBin' is
     // linear/constant, and the lookup/removal in 'nextInBin' is
     // constant/constant.  Hopefully this is a significant improvement
-    // over the current fully linear insertion.
+    // over the current fully linear insertion.  A calendar event
+    // queue keeps one such list of bins per bucket.
     Event *nextBin;
     Event *nextInBin;
 
@@ -496,6 +502,53 @@ class EventQueue
     Event *head;
     Tick _curTick;
 
+    /**
+     * Calendar queue (R. Brown, "Calendar Queues", CACM 1988).
+     *
+     * With a single list of bins, inserting an event walks every bin
+     * before it, which gets slow when many objects wake up at many
+     * distinct ticks. A calendar queue instead spreads the bins over
+     * a ring of buckets, each covering bucketWidth() ticks of a
+     * "year" of calendar.size() buckets, and keeps a sorted list of
+     * bins per bucket. Insertion only walks the bins of one bucket,
+     * and the next head is found by visiting the buckets of the
+     * current year in turn. Bins are unchanged, so events are
+     * serviced in exactly the same order as with the single list.
+     * 'head' still points to the earliest event.
+     *
+     * The number of buckets follows the number of events, and the
+     * bucket width is recomputed from the spacing of the earliest
+     * bins whenever the calendar is resized.
+     */
+    const bool useCalendar;
+    std::vector<Event *> calendar;
+    //! log2 of the number of ticks covered by a bucket
+    int bucketShift;
+    //! Number of events in the calendar
+    size_t numEvents;
+
+    Tick bucketWidth() const { return (Tick)1 << bucketShift; }
+
+    size_t
+    bucketOf(Tick when) const
+    {
+        return (when >> bucketShift) & (calendar.size() - 1);
+    }
+
+    //! Insert / remove event from a sorted list of bins
+    static void insertInBins(Event *&top, Event *event);
+    static void removeFromBins(Event *&top, Event *event);
+
+    void calendarInsert(Event *event);
+    void calendarRemove(Event *event);
+    //! Earliest event, given that no event is earlier than 'from'
+    Event *calendarHead(Tick from) const;
+    //! Spread the given sorted bins over num_buckets buckets
+    void fillCalendar(const std::vector<Event *> &bins, size_t num_buckets);
+
+    //! The bins of the queue in order, by their top event
+    std::vector<Event *> sortedBins() const;
+
     //! Mutex to protect async queue.
     std::mutex async_queue_mutex;
 
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file Helpers shared by the host benchmarks in this directory. A
+ * benchmark times its loops with seconds(), prints rate() of each, and
+ * checks that the implementations it compares agree with the EXPECT
+ * macros of unittest.hh, returning UnitTest::printResults() from main.
+ */
+
+#ifndef __UNITTEST_BENCHMARK_HH__
+#define __UNITTEST_BENCHMARK_HH__
+
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+
+#include "base/logging.hh"
+#include "base/str.hh"
+
+namespace Benchmark {
+
+/**
+ * Run a loop and measure it.
+ * @param loop The loop to run.
+ * @return Host time taken by the loop, in seconds.
+ */
+template <class Loop>
+double
+seconds(Loop &&loop)
+{
+    const auto start = std::chrono::steady_clock::now();
+    loop();
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @param ops Number of operations performed.
+ * @param secs Host time they took, in seconds.
+ * @return Number of operations per second.
+ */
+inline uint64_t
+rate(uint64_t ops, double secs)
+{
+    return secs > 0 ? ops / secs : 0;
+}
+
+/**
+ * Read the optional counts given on the command line, in order. The
+ * counts that are not given keep their default, and an argument that
+ * is not a positive number is fatal.
+ * @param argc Number of arguments, as passed to main.
+ * @param argv Arguments, as passed to main.
+ * @param usage Description of the arguments for the usage message.
+ * @param counts The counts, set to their defaults.
+ */
+inline void
+parseCounts(int argc, char *argv[], const char *usage,
+            std::initializer_list<int *> counts)
+{
+    if (argc - 1 > (int)counts.size())
+        fatal("usage: %s %s\n", argv[0], usage);
+
+    int arg = 1;
+    for (int *count : counts) {
+        if (arg == argc)
+            break;
+        if (!to_number(argv[arg++], *count) || *count <= 0)
+            fatal("usage: %s %s\n", argv[0], usage);
+    }
+}
+
+} // namespace Benchmark
+
+#endif // __UNITTEST_BENCHMARK_HH__
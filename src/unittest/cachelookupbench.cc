@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Lookup rate of the classic cache tag path: every lookup asks the
+// indexing policy for the candidate entries of an address and searches
+// them for a matching tag, as BaseTags::findBlock does. The candidates
+// are searched both through the view returned by the indexing policy and
+// through a by-value copy of them, which is what every lookup used to
+// cost. Both searches are checked against a reference built from the
+// addresses the indexing policy regenerates for the filled entries, so
+// a view returning the wrong candidates is caught whatever the copy
+// finds.
+//
+// usage: cachelookupbench [lookups]
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "base/cprintf.hh"
+#include "base/random.hh"
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
+#include "mem/cache/tags/indexing_policies/set_associative.hh"
+#include "mem/cache/tags/indexing_policies/skewed_associative.hh"
+#include "unittest/benchmark.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+
+// Geometry of the benchmarked tags: a 1MB, 8-way cache of 64B blocks,
+// and the number of distinct blocks the lookups are drawn from, which is
+// larger than the cache so that some of the lookups miss
+static const uint64_t cacheSize = 1 << 20;
+static const int blkSize = 64;
+static const int assoc = 8;
+static const int footprint = 2 * cacheSize / blkSize;
+
+class BenchEntry : public ReplaceableEntry
+{
+  public:
+    Addr tag;
+};
+
+static BenchEntry *
+findView(const BaseIndexingPolicy &policy, Addr addr)
+{
+    const Addr tag = policy.extractTag(addr);
+    const ReplacementCandidates entries = policy.getPossibleEntries(addr);
+    for (const auto &location : entries) {
+        BenchEntry *entry = static_cast<BenchEntry *>(location);
+        if (entry->tag == tag)
+            return entry;
+    }
+    return nullptr;
+}
+
+static BenchEntry *
+findCopy(const BaseIndexingPolicy &policy, Addr addr)
+{
+    const Addr tag = policy.extractTag(addr);
+    const ReplacementCandidates view = policy.getPossibleEntries(addr);
+    const vector<ReplaceableEntry *> entries(view.begin(), view.end());
+    for (const auto &location : entries) {
+        BenchEntry *entry = static_cast<BenchEntry *>(location);
+        if (entry->tag == tag)
+            return entry;
+    }
+    return nullptr;
+}
+
+template <class Params>
+static void
+run(const string &name, int num_lookups)
+{
+    Params params;
+    params.name = name;
+    params.eventq_index = 0;
+    params.size = cacheSize;
+    params.entry_size = blkSize;
+    params.assoc = assoc;
+    BaseIndexingPolicy *policy = params.create();
+
+    // Fill the cache with a random subset of the footprint, placing every
+    // block in the way its address maps to
+    Random rng(1);
+    vector<BenchEntry> entries(cacheSize / blkSize);
+    for (size_t i = 0; i < entries.size(); i++) {
+        policy->setEntry(&entries[i], i);
+        entries[i].tag = MaxAddr;
+    }
+    for (size_t i = 0; i < entries.size(); i++) {
+        Addr addr = (Addr)rng.random(0, footprint - 1) * blkSize;
+        ReplacementCandidates candidates = policy->getPossibleEntries(addr);
+        BenchEntry *entry = static_cast<BenchEntry *>(
+            candidates[rng.random<size_t>(0, candidates.size() - 1)]);
+        entry->tag = policy->extractTag(addr);
+    }
+
+    // The blocks the cache holds, as the indexing policy maps the filled
+    // entries back to addresses
+    unordered_set<Addr> cached;
+    for (const auto &entry : entries)
+        if (entry.tag != MaxAddr)
+            cached.insert(policy->regenerateAddr(entry.tag, &entry));
+
+    vector<Addr> addrs(num_lookups);
+    for (auto &addr : addrs)
+        addr = (Addr)rng.random(0, footprint - 1) * blkSize;
+
+    int view_hits = 0;
+    double view_time = Benchmark::seconds([&] {
+        for (auto addr : addrs)
+            view_hits += findView(*policy, addr) != nullptr;
+    });
+
+    int copy_hits = 0;
+    double copy_time = Benchmark::seconds([&] {
+        for (auto addr : addrs)
+            copy_hits += findCopy(*policy, addr) != nullptr;
+    });
+
+    // Every lookup must hit exactly the blocks of the reference, in the
+    // entry holding that very block
+    int ref_hits = 0;
+    int view_wrong = 0;
+    int copy_wrong = 0;
+    for (auto addr : addrs) {
+        const bool hit = cached.count(addr);
+        const BenchEntry *view = findView(*policy, addr);
+        const BenchEntry *copy = findCopy(*policy, addr);
+        ref_hits += hit;
+        view_wrong += view ? policy->regenerateAddr(view->tag, view) != addr
+                           : hit;
+        copy_wrong += copy ? policy->regenerateAddr(copy->tag, copy) != addr
+                           : hit;
+    }
+
+    UnitTest::setCase(name.c_str());
+    EXPECT_EQ(view_hits, ref_hits);
+    EXPECT_EQ(copy_hits, ref_hits);
+    EXPECT_EQ(view_wrong, 0);
+    EXPECT_EQ(copy_wrong, 0);
+
+    cprintf("%-8s view %10d/s  copy %10d/s  (%d hits)\n", name,
+            Benchmark::rate(num_lookups, view_time),
+            Benchmark::rate(num_lookups, copy_time), view_hits);
+
+    delete policy;
+}
+
+int
+main(int argc, char *argv[])
+{
+    int num_lookups = 10000000;
+    Benchmark::parseCounts(argc, argv, "[lookups]", { &num_lookups });
+
+    run<SetAssociativeParams>("set", num_lookups);
+    run<SkewedAssociativeParams>("skewed", num_lookups);
+
+    return UnitTest::printResults();
+}
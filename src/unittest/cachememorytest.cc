@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Tag lookups of the ruby CacheMemory, including the protocol bug the
+// cache tolerates: an entry left NotPresent in the cache, whose way is
+// only reused by a later allocation.
+
+#include "mem/cache/replacement_policies/lru_rp.hh"
+#include "mem/ruby/slicc_interface/AbstractCacheEntry.hh"
+#include "mem/ruby/structures/CacheMemory.hh"
+#include "params/LRURP.hh"
+#include "params/RubyCache.hh"
+#include "sim/eventq.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+
+static const int blkSize = 64;
+static const int numSets = 4;
+static const int assoc = 4;
+
+class TestEntry : public AbstractCacheEntry
+{
+  public:
+    void print(ostream &out) const override { out << "[TestEntry]"; }
+};
+
+int
+main()
+{
+    curEventQueue(getEventQueue(0));
+
+    // like any SimObject, the cache and its parameters are never freed
+    LRURPParams *rp_params = new LRURPParams;
+    rp_params->name = "replacement_policy";
+    rp_params->eventq_index = 0;
+
+    RubyCacheParams *params = new RubyCacheParams;
+    params->name = "cache";
+    params->eventq_index = 0;
+    params->assoc = assoc;
+    params->block_size = blkSize;
+    params->dataAccessLatency = Cycles(1);
+    params->dataArrayBanks = 1;
+    params->is_icache = false;
+    params->replacement_policy = rp_params->create();
+    params->resourceStalls = false;
+    params->ruby_system = nullptr;
+    params->size = numSets * assoc * blkSize;
+    params->start_index_bit = floorLog2(blkSize);
+    params->tagAccessLatency = Cycles(1);
+    params->tagArrayBanks = 1;
+    CacheMemory *cache = params->create();
+    cache->init();
+
+    // lines of the same set
+    const Addr a = 0;
+    const Addr b = numSets * blkSize;
+    const Addr c = 2 * numSets * blkSize;
+
+    UnitTest::setCase("allocate and deallocate");
+    AbstractCacheEntry *entry_a = cache->allocate(a, new TestEntry);
+    AbstractCacheEntry *entry_b = cache->allocate(b, new TestEntry);
+    EXPECT_TRUE(cache->isTagPresent(a));
+    EXPECT_TRUE(cache->isTagPresent(b));
+    EXPECT_FALSE(cache->isTagPresent(c));
+    EXPECT_EQ(cache->lookup(a), entry_a);
+    EXPECT_EQ(cache->lookup(b), entry_b);
+    cache->deallocate(a);
+    EXPECT_FALSE(cache->isTagPresent(a));
+    EXPECT_EQ(cache->lookup(a), nullptr);
+    EXPECT_EQ(cache->lookup(b), entry_b);
+
+    // b is left NotPresent in the second way, and allocated again in the
+    // first one: the tag must map to the new entry, not the stale one
+    UnitTest::setCase("reallocate over a NotPresent entry");
+    entry_b->m_Permission = AccessPermission_NotPresent;
+    EXPECT_FALSE(cache->isTagPresent(b));
+    EXPECT_EQ(cache->lookup(b), nullptr);
+    AbstractCacheEntry *new_b = cache->allocate(b, new TestEntry);
+    EXPECT_TRUE(cache->isTagPresent(b));
+    EXPECT_EQ(cache->lookup(b), new_b);
+
+    // the way of the stale entry is reused, and the tag of b stays put
+    UnitTest::setCase("reuse the way of a NotPresent entry");
+    AbstractCacheEntry *entry_c = cache->allocate(c, new TestEntry);
+    EXPECT_EQ(cache->lookup(c), entry_c);
+    EXPECT_EQ(cache->lookup(b), new_b);
+    cache->deallocate(b);
+    EXPECT_FALSE(cache->isTagPresent(b));
+    EXPECT_EQ(cache->lookup(c), entry_c);
+
+    return UnitTest::printResults();
+}
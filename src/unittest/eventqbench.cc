@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Schedule, deschedule and service rates of the list and calendar
+// event queues, on a "hold" workload: every serviced event schedules
+// itself again a random number of clock periods later, as the ruby and
+// garnet consumers do, and every few events another event is moved.
+// Both queues must service the events in the same order.
+//
+// usage: eventqbench [events [operations]]
+
+#include <string>
+#include <vector>
+
+#include "base/cprintf.hh"
+#include "base/random.hh"
+#include "sim/eventq_impl.hh"
+#include "unittest/benchmark.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+
+// Ticks of a clock period, and the number of periods events are
+// scheduled ahead
+static const Tick period = 500;
+static const int horizon = 64;
+
+static vector<int> serviced;
+
+class BenchEvent : public Event
+{
+  public:
+    BenchEvent(int _id, Priority p) : Event(p), id(_id) {}
+
+    void process() override { serviced.push_back(id); }
+    const char *description() const override { return "bench"; }
+
+    const int id;
+};
+
+static vector<int>
+run(const string &name, bool calendar, int num_events, int num_ops)
+{
+    const Event::Priority prios[] = { Event::Default_Pri,
+                                      Event::CPU_Tick_Pri,
+                                      Event::Stat_Event_Pri };
+
+    useCalendarEventQueue = calendar;
+    EventQueue eq(name);
+    Random rng(1);
+    serviced.clear();
+    serviced.reserve(num_ops);
+
+    vector<BenchEvent *> events;
+    for (int i = 0; i < num_events; i++)
+        events.push_back(new BenchEvent(i, prios[rng.random(0, 2)]));
+
+    double schedule_time = Benchmark::seconds([&] {
+        for (auto e : events)
+            eq.schedule(e, period * rng.random(1, horizon));
+    });
+
+    int moved = 0;
+    double hold_time = Benchmark::seconds([&] {
+        for (int op = 0; op < num_ops; op++) {
+            eq.serviceOne();
+            BenchEvent *e = events[serviced.back()];
+            eq.schedule(e,
+                        eq.getCurTick() + period * rng.random(1, horizon));
+
+            if (op % 8 == 0) {
+                BenchEvent *other = events[rng.random(0, num_events - 1)];
+                eq.deschedule(other);
+                eq.schedule(other, eq.getCurTick() +
+                            period * rng.random(1, horizon));
+                moved++;
+            }
+        }
+    });
+
+    for (auto e : events) {
+        eq.deschedule(e);
+        delete e;
+    }
+
+    cprintf("%-8s schedule %10d/s  hold %10d/s  (%d moved)\n", name,
+            Benchmark::rate(num_events, schedule_time),
+            Benchmark::rate(num_ops, hold_time), moved);
+
+    return serviced;
+}
+
+int
+main(int argc, char *argv[])
+{
+    int num_events = 20000;
+    int num_ops = 1000000;
+    Benchmark::parseCounts(argc, argv, "[events [operations]]",
+                           { &num_events, &num_ops });
+
+    vector<int> list_order = run("list", false, num_events, num_ops);
+    vector<int> calendar_order = run("calendar", true, num_events, num_ops);
+
+    UnitTest::setCase("service order");
+    EXPECT_TRUE(list_order == calendar_order);
+
+    return UnitTest::printResults();
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Enqueue and dequeue rates of a ruby MessageBuffer. A producer enqueues
+// a few messages every cycle, and the consumer of the buffer drains it
+// whenever it is woken up, as a controller does with its in ports.
+// Three kinds of traffic are timed: messages arriving in order, which
+// the buffer keeps in its FIFO; the same with a quarter of them recycled
+// once, which sends those through the priority heap; and the random
+// delays of the buffer itself, which put most messages in the heap. In
+// all of them the messages must leave in arrival time order, ties being
+// broken by enqueue order.
+//
+// usage: msgbufferbench [messages [per cycle]]
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/cprintf.hh"
+#include "mem/ruby/common/Consumer.hh"
+#include "mem/ruby/network/MessageBuffer.hh"
+#include "mem/ruby/slicc_interface/Message.hh"
+#include "params/MessageBuffer.hh"
+#include "params/SrcClockDomain.hh"
+#include "params/VoltageDomain.hh"
+#include "sim/clock_domain.hh"
+#include "sim/clocked_object.hh"
+#include "sim/eventq_impl.hh"
+#include "sim/voltage_domain.hh"
+#include "unittest/benchmark.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+
+// Ticks of a clock period, and the latency of a recycled message
+static const Tick period = 1000;
+static const Tick recycleLatency = 3 * period;
+
+class BenchMessage : public Message
+{
+  public:
+    BenchMessage(Tick cur_time) : Message(cur_time) {}
+
+    MsgPtr clone() const override { return MsgPtr(new BenchMessage(*this)); }
+    void print(ostream &out) const override { out << "[BenchMessage]"; }
+    bool functionalRead(Packet *pkt) override { return false; }
+    bool functionalWrite(Packet *pkt) override { return false; }
+};
+
+class BenchProducer
+{
+  public:
+    BenchProducer(ClockedObject *_em, MessageBuffer *_buffer,
+                  int num_msgs, int per_cycle)
+        : em(_em), buffer(_buffer), remaining(num_msgs),
+          perCycle(per_cycle), event([this]{ produce(); }, "producer")
+    {
+        em->schedule(event, curTick());
+    }
+
+  private:
+    void
+    produce()
+    {
+        for (int i = 0; i < perCycle && remaining > 0; i++, remaining--)
+            buffer->enqueue(MsgPtr(new BenchMessage(curTick())), curTick(),
+                            period);
+        if (remaining > 0)
+            em->schedule(event, curTick() + period);
+    }
+
+    ClockedObject *em;
+    MessageBuffer *buffer;
+    int remaining;
+    const int perCycle;
+    EventFunctionWrapper event;
+};
+
+class BenchConsumer : public Consumer
+{
+  public:
+    BenchConsumer(ClockedObject *em, MessageBuffer *_buffer,
+                  int recycle_every)
+        : Consumer(em), buffer(_buffer), recycleEvery(recycle_every)
+    {
+        buffer->setConsumer(this);
+    }
+
+    void
+    wakeup() override
+    {
+        const Tick now = curTick();
+        while (buffer->isReady(now)) {
+            const Message *msg = buffer->peek();
+            // recycle some of the messages, once
+            if (recycleEvery && msg->getMsgCounter() % recycleEvery == 0 &&
+                msg->getLastEnqueueTime() == msg->getTime() + period) {
+                buffer->recycle(now, recycleLatency);
+                continue;
+            }
+            order.emplace_back(msg->getLastEnqueueTime(),
+                               msg->getMsgCounter());
+            buffer->dequeue(now);
+        }
+    }
+
+    void print(ostream &out) const override { out << "[BenchConsumer]"; }
+
+    /** Arrival time and enqueue order of the dequeued messages */
+    vector<pair<Tick, uint64_t>> order;
+
+  private:
+    MessageBuffer *buffer;
+    const int recycleEvery;
+};
+
+static void
+run(const string &name, ClockedObject *em, bool randomization,
+    int recycle_every, int num_msgs, int per_cycle)
+{
+    // like any SimObject, the buffer and its parameters are never freed
+    MessageBufferParams *params = new MessageBufferParams;
+    params->name = name;
+    params->eventq_index = 0;
+    params->buffer_size = 0;
+    params->ordered = false;
+    params->randomization = randomization;
+    MessageBuffer *buffer = params->create();
+
+    BenchConsumer consumer(em, buffer, recycle_every);
+    consumer.order.reserve(num_msgs);
+    BenchProducer producer(em, buffer, num_msgs, per_cycle);
+
+    EventQueue *eq = em->eventQueue();
+    double time = Benchmark::seconds([&] {
+        while (!eq->empty())
+            eq->serviceOne();
+    });
+
+    UnitTest::setCase(name.c_str());
+    EXPECT_EQ(consumer.order.size(), num_msgs);
+    EXPECT_TRUE(is_sorted(consumer.order.begin(), consumer.order.end()));
+    EXPECT_TRUE(buffer->isEmpty());
+
+    cprintf("%-10s %10d messages/s\n", name,
+            Benchmark::rate(num_msgs, time));
+}
+
+int
+main(int argc, char *argv[])
+{
+    int num_msgs = 1000000;
+    int per_cycle = 4;
+    Benchmark::parseCounts(argc, argv, "[messages [per cycle]]",
+                           { &num_msgs, &per_cycle });
+
+    curEventQueue(getEventQueue(0));
+
+    VoltageDomainParams voltage_params;
+    voltage_params.name = "voltage_domain";
+    voltage_params.eventq_index = 0;
+    voltage_params.voltage = { 1.0 };
+
+    SrcClockDomainParams clock_params;
+    clock_params.name = "clk_domain";
+    clock_params.eventq_index = 0;
+    clock_params.clock = { period };
+    clock_params.domain_id = -1;
+    clock_params.init_perf_level = 0;
+    clock_params.voltage_domain = voltage_params.create();
+
+    ClockedObjectParams params;
+    params.name = "controller";
+    params.eventq_index = 0;
+    params.clk_domain = clock_params.create();
+    params.default_p_state = Enums::UNDEFINED;
+    params.p_state_clk_gate_bins = 20;
+    params.p_state_clk_gate_min = 1000;
+    params.p_state_clk_gate_max = 1000000000000;
+    ClockedObject em(&params);
+
+    run("in order", &em, false, 0, num_msgs, per_cycle);
+    run("recycled", &em, false, 4, num_msgs, per_cycle);
+    run("random", &em, true, 0, num_msgs, per_cycle);
+
+    return UnitTest::printResults();
+}
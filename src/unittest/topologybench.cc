@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Start-up cost of the Ruby routing tables: Topology computes the
+// distance from every switch to every destination node, and a link
+// routes to the nodes it is on a shortest path to. This times the
+// per-destination search Topology uses against the all-pairs
+// relaxation it replaced, and checks that both give the same routing
+// table for every link, on meshes with XY routing weights and on a
+// dragonfly. The switches are numbered as Topology numbers them: the
+// links into the network of the nodes first, then the links out of the
+// network, then the routers.
+//
+// usage: topologybench [mesh rows] [dragonfly global links per router]
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/cprintf.hh"
+#include "mem/ruby/network/Topology.hh"
+#include "unittest/benchmark.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+
+// As in Topology.cc
+static const int INFINITE_LATENCY = 10000;
+
+// Number of controllers on each router, e.g. an L1, an L2 bank and a
+// directory
+static const int nodesPerRouter = 3;
+
+// Weight of each link, by (source switch, destination switch)
+typedef map<pair<int, int>, int> Links;
+
+struct Graph
+{
+    int numNodes;
+    int numRouters;
+    Links links;
+
+    Graph(int num_routers)
+        : numNodes(num_routers * nodesPerRouter), numRouters(num_routers)
+    {
+        // the bi-directional external links, with the default weight
+        for (int node = 0; node < numNodes; node++) {
+            int router = routerSwitch(node / nodesPerRouter);
+            links[make_pair(node, router)] = 1;
+            links[make_pair(router, node + numNodes)] = 1;
+        }
+    }
+
+    int routerSwitch(int router) const { return 2 * numNodes + router; }
+
+    void
+    addIntLink(int src, int dst, int weight)
+    {
+        links[make_pair(routerSwitch(src), routerSwitch(dst))] = weight;
+    }
+
+    int numSwitches() const { return 2 * numNodes + numRouters; }
+};
+
+// As configs/topologies/Mesh_XY.py: X links have weight 1 and Y links
+// weight 2, so that the routes go along X first
+static Graph
+mesh(int rows, int cols)
+{
+    Graph net(rows * cols);
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+            int router = row * cols + col;
+            if (col + 1 < cols) {
+                net.addIntLink(router, router + 1, 1);
+                net.addIntLink(router + 1, router, 1);
+            }
+            if (row + 1 < rows) {
+                net.addIntLink(router, router + cols, 2);
+                net.addIntLink(router + cols, router, 2);
+            }
+        }
+    }
+    return net;
+}
+
+// A balanced dragonfly with h global links per router: groups of 2h
+// fully connected routers, and 2h^2 + 1 groups with one global link
+// between each pair of groups. The global links are given a higher
+// weight, so that there are several minimal routes of equal weight.
+static Graph
+dragonfly(int h)
+{
+    const int a = 2 * h;
+    const int groups = a * h + 1;
+    Graph net(a * groups);
+    for (int g = 0; g < groups; g++) {
+        for (int i = 0; i < a; i++) {
+            for (int j = 0; j < a; j++) {
+                if (i != j)
+                    net.addIntLink(g * a + i, g * a + j, 1);
+            }
+        }
+    }
+    // the k-th global link of group g goes to group g + k + 1, from
+    // router k / h of g, and lands on the router of the other group
+    // whose global link goes back to g
+    for (int g = 0; g < groups; g++) {
+        for (int k = 0; k < a * h; k++) {
+            int other = (g + k + 1) % groups;
+            int back = groups - 2 - k;
+            net.addIntLink(g * a + k / h, other * a + back / h, 3);
+        }
+    }
+    return net;
+}
+
+// The distances as Topology used to compute them, dist[switch][switch]:
+// relax all pairs of switches through every intermediate switch until
+// nothing changes (Cormen et al., Chapter 26.1)
+static Matrix
+relaxedDistances(const Graph &net)
+{
+    const int num_switches = net.numSwitches();
+    Matrix dist(num_switches, vector<int>(num_switches, INFINITE_LATENCY));
+    for (int i = 0; i < num_switches; i++)
+        dist[i][i] = 0;
+    for (const auto &link : net.links)
+        dist[link.first.first][link.first.second] = link.second;
+
+    bool change = true;
+    while (change) {
+        change = false;
+        for (int i = 0; i < num_switches; i++) {
+            for (int j = 0; j < num_switches; j++) {
+                int minimum = dist[i][j];
+                for (int k = 0; k < num_switches; k++)
+                    minimum = min(minimum, dist[i][k] + dist[k][j]);
+                if (dist[i][j] != minimum) {
+                    change = true;
+                    dist[i][j] = minimum;
+                }
+            }
+        }
+    }
+    return dist;
+}
+
+static Matrix
+searchedDistances(const Graph &net)
+{
+    Topology::InLinks in_links(net.numSwitches());
+    for (const auto &link : net.links) {
+        if (link.first.first != link.first.second) {
+            in_links[link.first.second].push_back(
+                make_pair(link.second, link.first.first));
+        }
+    }
+    return Topology::shortest_path(net.numNodes, in_links);
+}
+
+// The routing table of every link, as the nodes each link routes to
+typedef vector<vector<bool> > RoutingTables;
+
+static RoutingTables
+relaxedTables(const Graph &net, const Matrix &dist)
+{
+    RoutingTables tables;
+    for (const auto &link : net.links) {
+        int src = link.first.first;
+        int next = link.first.second;
+        int weight = link.second;
+        vector<bool> table(net.numNodes);
+        for (int node = 0; node < net.numNodes; node++) {
+            int final = node + net.numNodes;
+            table[node] = weight + dist[next][final] == dist[src][final];
+        }
+        tables.push_back(table);
+    }
+    return tables;
+}
+
+static RoutingTables
+searchedTables(const Graph &net, const Matrix &dist)
+{
+    RoutingTables tables;
+    for (const auto &link : net.links) {
+        int src = link.first.first;
+        int next = link.first.second;
+        int weight = link.second;
+        vector<bool> table(net.numNodes);
+        for (int node = 0; node < net.numNodes; node++)
+            table[node] = weight + dist[node][next] == dist[node][src];
+        tables.push_back(table);
+    }
+    return tables;
+}
+
+static void
+run(const string &name, const Graph &net)
+{
+    RoutingTables relaxed, searched;
+
+    double relaxed_time = Benchmark::seconds([&] {
+        relaxed = relaxedTables(net, relaxedDistances(net));
+    });
+    double searched_time = Benchmark::seconds([&] {
+        searched = searchedTables(net, searchedDistances(net));
+    });
+
+    int entries = 0;
+    int wrong = 0;
+    for (size_t i = 0; i < relaxed.size(); i++) {
+        for (int node = 0; node < net.numNodes; node++) {
+            entries += relaxed[i][node];
+            wrong += relaxed[i][node] != searched[i][node];
+        }
+    }
+
+    UnitTest::setCase(name.c_str());
+    EXPECT_EQ(relaxed.size(), net.links.size());
+    EXPECT_EQ(searched.size(), net.links.size());
+    EXPECT_EQ(wrong, 0);
+
+    cprintf("%-16s %4d switches  relaxation %8.3fs  search %8.3fs  "
+            "(%d entries)\n", name, net.numSwitches(), relaxed_time,
+            searched_time, entries);
+}
+
+int
+main(int argc, char *argv[])
+{
+    int mesh_rows = 8;
+    int global_links = 2;
+    Benchmark::parseCounts(argc, argv,
+                           "[mesh rows] [dragonfly global links per router]",
+                           { &mesh_rows, &global_links });
+
+    for (int rows = 2; rows <= mesh_rows; rows *= 2) {
+        run(csprintf("mesh %dx%d", rows, rows), mesh(rows, rows));
+        run(csprintf("mesh %dx%d", rows, 2 * rows), mesh(rows, 2 * rows));
+    }
+    for (int h = 1; h <= global_links; h++)
+        run(csprintf("dragonfly h=%d", h), dragonfly(h));
+
+    return UnitTest::printResults();
+}
@@ -0,0 +1,52 @@
+# Copyright (c) 2026 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+'''
+Test file for garnet2.0 simulated on several host threads
+'''
+from testlib import *
+
+config_file = joinpath(config.base_dir, 'configs', 'example',
+                       'garnet_synth_traffic.py')
+config_args = ['--network=garnet2.0', '--topology=Mesh_XY',
+               '--mesh-rows=4', '--num-cpus=16', '--num-dirs=16',
+               '--synthetic=uniform_random', '--injectionrate=0.1',
+               '--sim-cycles=20000']
+
+# The routers split between four event queues must give the same network
+# stats as the serial run, with the same (default) random seed. The object
+# pools are per host thread, so they carve out a different capacity.
+gem5_verify_config(
+    name='garnet_network_threads',
+    verifiers=(verifier.MatchStatsOfRun(
+        config_file, config_args + ['--network-threads=1'],
+        stats_regex=(r'^sim_ticks$', r'^system\.ruby\.network\.'),
+        ignore_regex=r'^system\.ruby\.network\.pool_capacity'),),
+    config=config_file,
+    config_args=config_args + ['--network-threads=4'],
+    valid_isas=(constants.null_tag,),
+    protocol='Garnet_standalone',
+)
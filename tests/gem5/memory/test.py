@@ -67,3 +67,25 @@ gem5_verify_config(
     config_args = [],
     valid_isas=(constants.null_tag,),
 )
+
+# Many testers sharing one coherent crossbar, all tracked by its snoop
+# filter, with lines grouped by region and by page
+for region in ('64B', '4kB'):
+    gem5_verify_config(
+        name='memtest_snoop_filter_' + region,
+        verifiers=(), # No need for verfiers this will return non-zero on fail
+        config=joinpath(config.base_dir, 'configs', 'example', 'memtest.py'),
+        config_args = ['-c', '64', '-t', '0:1', '-l', '10000',
+                       '--snoop-region', region],
+        valid_isas=(constants.null_tag,),
+        )
+
+# Two-rank DRAM controllers going idle between bursts of traffic, which
+# end up with the same stats whether or not they skip idle refreshes
+gem5_verify_config(
+    name='dram_skip_idle_refresh',
+    verifiers=(), # No need for verfiers this will return non-zero on fail
+    config=joinpath(getcwd(), 'dram-refresh-skip-run.py'),
+    config_args = [],
+    valid_isas=(constants.null_tag,),
+)
@@ -33,7 +33,7 @@ import re
 
 from testlib import test
 from testlib.config import constants
-from testlib.helper import joinpath, diff_out_file
+from testlib.helper import joinpath, diff_out_file, log_call
 
 class Verifier(object):
     def __init__(self, fixtures=tuple()):
@@ -199,6 +199,60 @@ class MatchRegex(Verifier):
         self.failed(fixtures)
         test.fail('Could not match regex.')
 
+class MatchStatsOfRun(Verifier):
+    '''
+    Runs gem5 again with another config, and compares the stats of the
+    two runs, e.g. to check that an option does not change the results.
+    '''
+    def __init__(self, config, config_args, stats_regex, ignore_regex=()):
+        '''
+        :param config: The config to run gem5 again with.
+        :param config_args: A list of arguments to pass to the config.
+        :param stats_regex: A string, compiled regex, or iterable
+            containing either which selects the stats to compare by name.
+        :param ignore_regex: As stats_regex, for the stats to leave out.
+        '''
+        super(MatchStatsOfRun, self).__init__()
+        self.config = config
+        self.config_args = config_args
+        self.stats_regex = _iterable_regex(stats_regex)
+        self.ignore_regex = _iterable_regex(ignore_regex)
+
+    def _stats(self, outdir):
+        stats = {}
+        fname = joinpath(outdir, constants.gem5_simulation_stats)
+        with open(fname, 'r') as file_:
+            for line in file_:
+                fields = line.split()
+                if not fields:
+                    continue
+                name = fields[0]
+                if any(re.match(regex, name) for regex in self.stats_regex) \
+                   and not any(re.match(regex, name)
+                               for regex in self.ignore_regex):
+                    stats[name] = fields[1:]
+        return stats
+
+    def test(self, params):
+        fixtures = params.fixtures
+        tempdir = fixtures[constants.tempdir_fixture_name].path
+        gem5 = fixtures[constants.gem5_binary_fixture_name].path
+        other = joinpath(tempdir, 'other')
+        command = [gem5, '-d', other, '-re', self.config]
+        command.extend(self.config_args)
+        log_call(params.log, command)
+
+        stats = self._stats(tempdir)
+        other_stats = self._stats(other)
+        if not stats or stats != other_stats:
+            diff = ['%s: %s != %s' % (name, stats.get(name),
+                                      other_stats.get(name))
+                    for name in sorted(set(stats) | set(other_stats))
+                    if stats.get(name) != other_stats.get(name)]
+            self.failed(fixtures)
+            test.fail('Stats did not match:\n%s\nSee %s for full results'
+                      % ('\n'.join(diff), tempdir))
+
 _re_type = type(re.compile(''))
 def _iterable_regex(regex):
     if isinstance(regex, _re_type) or isinstance(regex, str):
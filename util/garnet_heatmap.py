@@ -0,0 +1,216 @@
+#!/usr/bin/env python
+#
+# Copyright (c) 2026 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Renders the per-router activity of a garnet2.0 run as heatmaps laid out
+# like the mesh (router 0 in the bottom left corner) and ranks the links
+# with the highest utilization. It reads stats.txt and config.ini from the
+# output directory; the last stats dump is used. With --plot (and
+# matplotlib) the heatmaps are drawn to an image, otherwise they are
+# printed as text. See also --network-report in configs/network/Network.py
+# for the same report written by the simulator itself.
+
+from __future__ import print_function
+
+import argparse
+import os
+import sys
+
+try:
+    from configparser import RawConfigParser
+except ImportError:
+    from ConfigParser import RawConfigParser
+
+ROUTER_STATS = [
+    ("buffer_reads", "Buffer reads"),
+    ("buffer_writes", "Buffer writes"),
+    ("crossbar_activity", "Crossbar activity"),
+    ("link_utilization", "Highest outgoing link utilization (flits/cycle)"),
+    ("smart_hops", "SMART hops ending at the router"),
+    ("smart_hop_routers", "Routers per SMART hop ending at the router"),
+]
+
+SHADES = " .:-=+*#%@"
+
+def parse_stats(path):
+    stats = {}
+    with open(path) as f:
+        for line in f:
+            if line.startswith("---------- Begin Simulation Statistics"):
+                stats = {}
+                continue
+            fields = line.split()
+            if len(fields) < 2:
+                continue
+            try:
+                stats[fields[0]] = float(fields[1])
+            except ValueError:
+                pass
+    return stats
+
+def find_network(config):
+    for section in config.sections():
+        if config.has_option(section, "type") and \
+           config.get(section, "type") == "GarnetNetwork":
+            return section
+    print("No GarnetNetwork in config.ini", file=sys.stderr)
+    sys.exit(1)
+
+# src and dest are router ids, or the controller at the NI end
+class Link(object):
+    def __init__(self, path, kind, src, dest, src_router, stats):
+        self.path = path
+        self.kind = kind
+        self.src = str(src)
+        self.dest = str(dest)
+        self.src_router = src_router
+        self.flits = stats.get(path + ".flits", 0)
+        self.utilization = stats.get(path + ".utilization", 0)
+
+def parse_network(config, stats):
+    network = find_network(config)
+    routers = config.get(network, "routers").split()
+    router_id = dict((r, config.getint(r, "router_id")) for r in routers)
+
+    values = dict((name, [0.0] * len(routers)) for name, _ in ROUTER_STATS)
+    for router in routers:
+        i = router_id[router]
+        for name, _ in ROUTER_STATS:
+            values[name][i] = stats.get(router + "." + name, 0)
+        if values["smart_hops"][i] > 0:
+            values["smart_hop_routers"][i] /= values["smart_hops"][i]
+
+    links = []
+    for link in config.get(network, "int_links").split():
+        src = router_id[config.get(link, "src_node")]
+        dest = router_id[config.get(link, "dst_node")]
+        links.append(Link(config.get(link, "network_link"),
+                          "router -> router", src, dest, src, stats))
+    for link in config.get(network, "ext_links").split():
+        # [0]: NI -> router, [1]: router -> NI
+        nls = config.get(link, "network_links").split()
+        router = router_id[config.get(link, "int_node")]
+        cntrl = config.get(link, "ext_node").split(".")[-1]
+        links.append(Link(nls[0], "NI -> router", cntrl, router, None,
+                          stats))
+        links.append(Link(nls[1], "router -> NI", router, cntrl, router,
+                          stats))
+
+    util = values["link_utilization"]
+    for link in links:
+        if link.src_router is not None:
+            util[link.src_router] = max(util[link.src_router],
+                                        link.utilization)
+
+    num_cols = len(routers)
+    num_rows = config.getint(network, "num_rows")
+    if num_rows > 0:
+        num_cols = len(routers) // num_rows
+    else:
+        num_cols = min(8, len(routers))
+
+    return values, links, num_cols
+
+def print_heatmap(title, values, num_cols):
+    max_value = max(values)
+    print("%s (max %.4g)" % (title, max_value))
+    num_rows = (len(values) + num_cols - 1) // num_cols
+    for row in reversed(range(num_rows)):
+        cells = []
+        for router in range(row * num_cols,
+                            min((row + 1) * num_cols, len(values))):
+            shade = 0
+            if max_value > 0:
+                shade = int(values[router] / max_value * (len(SHADES) - 1))
+            cells.append(" %10.4g %s" % (values[router], SHADES[shade]))
+        print("%5d |%s" % (row * num_cols, "".join(cells)))
+    print()
+
+def plot_heatmaps(values, num_cols, path):
+    try:
+        import matplotlib
+        matplotlib.use("Agg")
+        import matplotlib.pyplot as plt
+    except ImportError:
+        print("Failed to import matplotlib", file=sys.stderr)
+        sys.exit(1)
+
+    num_rows = (len(values["buffer_reads"]) + num_cols - 1) // num_cols
+    fig, axes = plt.subplots(2, 3, figsize=(15, 9))
+    for ax, (name, title) in zip(axes.flat, ROUTER_STATS):
+        grid = [[0.0] * num_cols for _ in range(num_rows)]
+        for router, value in enumerate(values[name]):
+            grid[router // num_cols][router % num_cols] = value
+        image = ax.imshow(grid, origin="lower", cmap="hot",
+                          interpolation="nearest")
+        ax.set_title(title, fontsize=9)
+        for router, value in enumerate(values[name]):
+            ax.text(router % num_cols, router // num_cols, str(router),
+                    ha="center", va="center", color="cyan", fontsize=7)
+        fig.colorbar(image, ax=ax)
+    fig.tight_layout()
+    fig.savefig(path)
+    print("Heatmaps written to %s" % path)
+
+def main():
+    parser = argparse.ArgumentParser(description="Garnet router heatmaps "
+                                     "and bottleneck links of a run")
+    parser.add_argument("outdir", help="gem5 output directory")
+    parser.add_argument("--top", type=int, default=10,
+                        help="number of links to rank (default: 10)")
+    parser.add_argument("--plot", metavar="FILE",
+                        help="draw the heatmaps to this image file")
+    args = parser.parse_args()
+
+    config = RawConfigParser()
+    if not config.read(os.path.join(args.outdir, "config.ini")):
+        print("Failed to read config.ini in %s" % args.outdir,
+              file=sys.stderr)
+        sys.exit(1)
+    stats = parse_stats(os.path.join(args.outdir, "stats.txt"))
+
+    values, links, num_cols = parse_network(config, stats)
+
+    if args.plot:
+        plot_heatmaps(values, num_cols, args.plot)
+    else:
+        for name, title in ROUTER_STATS:
+            if name.startswith("smart") and not any(values[name]):
+                continue
+            print_heatmap(title, values[name], num_cols)
+
+    links.sort(key=lambda link: link.utilization, reverse=True)
+    print("Busiest links (src and dest are routers, or the controller at "
+          "the NI end)")
+    print("%4s  %-16s %12s %12s %12s %12s  %s" % ("rank", "type", "src",
+          "dest", "flits", "flits/cycle", "link"))
+    for rank, link in enumerate(links[:args.top]):
+        print("%4d  %-16s %12s %12s %12d %12.4f  %s" % (rank + 1, link.kind,
+              link.src, link.dest, link.flits, link.utilization, link.path))
+
+if __name__ == "__main__":
+    main()